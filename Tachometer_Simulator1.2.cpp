@@ -9,9 +9,57 @@
 #include <cstdint>
 #include <random>
 #include <cmath>
+#include <limits>
 #include <iostream>
 #include <fstream>
 #include <ostream>
+#include <sstream>
+#include <charconv>
+#include <vector>
+#include <array>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <csignal>
+#include <cstring>
+#include <cctype>
+#include <cerrno>
+#include <new>
+#include <type_traits>
+#include <functional>
+#include <deque>
+#include <unordered_map>
+#include <list>
+#include <tuple>
+#include <memory>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
+
+#define TACHSIM_BUILDING
+#include "tachsim.h"
 
 // -----------------------------------------------------------------------------
 // Engine power bands
@@ -44,80 +92,596 @@ std::string to_string(EnginePowerBand band)
 }
 
 // -----------------------------------------------------------------------------
-// Core Tachometer engine logic
+// Metrics registry. Counters are sharded per thread (one cache line per
+// shard, relaxed atomics) so hot loops never contend; readers sum the
+// shards. Gauges are single atomics. Metrics are registered once, by name
+// plus an optional label set, and live for the whole process.
 // -----------------------------------------------------------------------------
-class EnginePowerModel
+inline std::size_t metric_thread_shard() noexcept
+{
+    static std::atomic<std::size_t> next{ 0 };
+    thread_local std::size_t shard = next.fetch_add(1, std::memory_order_relaxed);
+    return shard;
+}
+
+class MetricCounter
 {
+public:
+    void add(std::uint64_t n = 1) noexcept
+    {
+        shards_[metric_thread_shard() % k_shards].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    std::uint64_t value() const noexcept
+    {
+        std::uint64_t sum = 0;
+        for (const Shard& s : shards_)
+            sum += s.value.load(std::memory_order_relaxed);
+        return sum;
+    }
+
 private:
-    static constexpr int Idle_min    = 1000;
-    static constexpr int Idle_max    = 3500;
+    static constexpr std::size_t k_shards = 32;
 
-    static constexpr int Climb_min   = 3501;
-    static constexpr int Climb_max   = 6000;
+    struct alignas(64) Shard
+    {
+        std::atomic<std::uint64_t> value{ 0 };
+    };
 
-    static constexpr int Cruise_min  = 6001;
-    static constexpr int Cruise_max  = 9000;
+    Shard shards_[k_shards];
+};
 
-    static constexpr int Caution_min = 9001;
-    static constexpr int Caution_max = 9799;
+class MetricGauge
+{
+public:
+    void set(double v) noexcept { value_.store(v, std::memory_order_relaxed); }
+    double value() const noexcept { return value_.load(std::memory_order_relaxed); }
 
-    static constexpr int RedLine_min = 9800;
-    static constexpr int RedLine_max = 10200;
+private:
+    std::atomic<double> value_{ 0.0 };
+};
+
+class MetricsRegistry
+{
+public:
+    MetricCounter& counter(const std::string& name, const std::string& help, const std::string& labels = "")
+    {
+        return *find_or_add(name, help, labels, MetricKind::Counter).counter;
+    }
+
+    MetricGauge& gauge(const std::string& name, const std::string& help, const std::string& labels = "")
+    {
+        return *find_or_add(name, help, labels, MetricKind::Gauge).gauge;
+    }
+
+    // Prometheus text exposition format 0.0.4, one HELP/TYPE block per family.
+    std::string render_prometheus() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::ostringstream os;
+        std::string family;
+        for (const Metric& m : metrics_)
+        {
+            if (m.name != family)
+            {
+                family = m.name;
+                os << "# HELP " << m.name << ' ' << m.help << '\n'
+                   << "# TYPE " << m.name << ' ' << (m.kind == MetricKind::Counter ? "counter" : "gauge") << '\n';
+            }
+            os << m.name;
+            if (!m.labels.empty())
+                os << '{' << m.labels << '}';
+            if (m.kind == MetricKind::Counter)
+                os << ' ' << m.counter->value() << '\n';
+            else
+                os << ' ' << m.gauge->value() << '\n';
+        }
+        return os.str();
+    }
+
+private:
+    enum class MetricKind { Counter, Gauge };
+
+    struct Metric
+    {
+        std::string                    name;
+        std::string                    help;
+        std::string                    labels;
+        MetricKind                     kind;
+        std::unique_ptr<MetricCounter> counter;
+        std::unique_ptr<MetricGauge>   gauge;
+    };
+
+    Metric& find_or_add(const std::string& name, const std::string& help, const std::string& labels, MetricKind kind)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto family_end = metrics_.end();
+        for (auto it = metrics_.begin(); it != metrics_.end(); ++it)
+        {
+            if (it->name != name)
+                continue;
+            if (it->labels == labels)
+                return *it;
+            family_end = std::next(it);
+        }
+        // Keep a family's series adjacent so rendering emits HELP/TYPE once.
+        Metric m{ name, help, labels, kind, nullptr, nullptr };
+        if (kind == MetricKind::Counter)
+            m.counter.reset(new MetricCounter);
+        else
+            m.gauge.reset(new MetricGauge);
+        return *metrics_.insert(family_end, std::move(m));
+    }
+
+    mutable std::mutex mutex_;
+    std::list<Metric>  metrics_; // Stable addresses for handed-out references.
+};
+
+MetricsRegistry& metrics_registry()
+{
+    static MetricsRegistry registry;
+    return registry;
+}
+
+// The simulator's standard metrics, registered on first use.
+struct SimMetrics
+{
+    MetricCounter& ticks         = metrics_registry().counter("tachsim_ticks_total", "Engine ticks simulated.");
+    MetricGauge&   samples_rate  = metrics_registry().gauge("tachsim_samples_per_second", "Ticks simulated per second over the last exposition interval.");
+    MetricCounter& alerts        = metrics_registry().counter("tachsim_alerts_total", "Entries into RedLine or OverLimit.");
+    MetricGauge&   queue_depth   = metrics_registry().gauge("tachsim_queue_depth", "Current depth of the active work or sample queue.");
+    MetricCounter& bytes_written = metrics_registry().counter("tachsim_bytes_written_total", "Bytes written to logs and corpora.");
+    MetricCounter* band_seconds[7];
+
+    SimMetrics()
+    {
+        for (int b = 0; b < 7; ++b)
+            band_seconds[b] = &metrics_registry().counter(
+                "tachsim_band_seconds_total", "Simulated engine seconds per power band.",
+                "band=\"" + to_string(static_cast<EnginePowerBand>(b)) + "\"");
+    }
+
+    // Accounts for one tick of one engine; `previous` is the band before the tick.
+    void record_tick(EnginePowerBand previous, EnginePowerBand band, double delta_seconds)
+    {
+        ticks.add();
+        band_seconds[static_cast<int>(band)]->add(static_cast<std::uint64_t>(std::lround(delta_seconds)));
+        alerts.add(band >= EnginePowerBand::RedLine && previous < EnginePowerBand::RedLine);
+    }
+};
+
+SimMetrics& sim_metrics()
+{
+    static SimMetrics m;
+    return m;
+}
+
+// Thread-local tallies for loops that touch many engines per tick; flush()
+// hands them to the shared counters in one go.
+struct TickTally
+{
+    std::uint64_t ticks{ 0 };
+    std::uint64_t alerts{ 0 };
+    std::uint64_t band_seconds[7]{};
+
+    void add(EnginePowerBand previous, EnginePowerBand band, std::int64_t seconds) noexcept
+    {
+        ++ticks;
+        band_seconds[static_cast<int>(band)] += static_cast<std::uint64_t>(seconds);
+        alerts += band >= EnginePowerBand::RedLine && previous < EnginePowerBand::RedLine;
+    }
+
+    void flush()
+    {
+        SimMetrics& m = sim_metrics();
+        m.ticks.add(ticks);
+        m.alerts.add(alerts);
+        for (int b = 0; b < 7; ++b)
+            if (band_seconds[b])
+                m.band_seconds[b]->add(band_seconds[b]);
+        *this = TickTally{};
+    }
+
+    // The shared counters' current totals. A forked worker reports
+    // snapshot().since(start) so its parent can flush() the difference.
+    static TickTally snapshot()
+    {
+        SimMetrics& m = sim_metrics();
+        TickTally t;
+        t.ticks  = m.ticks.value();
+        t.alerts = m.alerts.value();
+        for (int b = 0; b < 7; ++b)
+            t.band_seconds[b] = m.band_seconds[b]->value();
+        return t;
+    }
+
+    TickTally since(const TickTally& earlier) const noexcept
+    {
+        TickTally d;
+        d.ticks  = ticks - earlier.ticks;
+        d.alerts = alerts - earlier.alerts;
+        for (int b = 0; b < 7; ++b)
+            d.band_seconds[b] = band_seconds[b] - earlier.band_seconds[b];
+        return d;
+    }
+};
+
+// -----------------------------------------------------------------------------
+// Input sanitization for replayed / external RPM data. Every sample gets a
+// flag byte (0 = valid) and a clamped value that is always safe to round.
+// The loops are written as selects and min/max so they compile to blends
+// instead of data-dependent branches and vectorize.
+// -----------------------------------------------------------------------------
+enum SampleFlag : std::uint8_t
+{
+    SampleValid     = 0,
+    SampleNonFinite = 1 << 0, // NaN or +/-Inf, replaced by 0.
+    SampleNegative  = 1 << 1, // Clamped to 0.
+    SampleOverRange = 1 << 2, // Above the plausible sensor range, clamped to it.
+    SampleSlew      = 1 << 3  // Jump from the previous sample exceeds the slew limit.
+};
+
+struct SanitizeLimits
+{
+    double max_rpm{ 20000.0 };              // Twice redline: anything above is a sensor fault.
+    double max_slew_rpm_per_sec{ 2000.0 };  // Spool-up/down rate a real engine cannot exceed. Only
+                                            // bites when samples are under max_rpm / rate (10 s) apart.
+};
+
+struct SanitizeReport
+{
+    std::uint64_t samples{ 0 };
+    std::uint64_t valid{ 0 };
+    std::uint64_t non_finite{ 0 };
+    std::uint64_t negative{ 0 };
+    std::uint64_t over_range{ 0 };
+    std::uint64_t slew{ 0 };
+};
+
+// Scalar form used on the per-sample path; `rpm` is clamped in place.
+inline std::uint8_t sanitize_rpm_value(double& rpm, double max_rpm) noexcept
+{
+    double x = rpm;
+    bool finite = (x - x) == 0.0;         // False for NaN and Inf.
+    double v = finite ? x : 0.0;
+    std::uint8_t flags = static_cast<std::uint8_t>(
+          (!finite ? SampleNonFinite : 0)
+        | (v < 0.0 ? SampleNegative : 0)
+        | (v > max_rpm ? SampleOverRange : 0));
+    rpm = std::min(std::max(v, 0.0), max_rpm);
+    return flags;
+}
+
+// Bulk form: sanitizes `count` RPM samples taken `sample_seconds` apart.
+// `out` may alias `in`. `previous_rpm` is the last clean sample before this
+// span (the first sample is not slew-checked when it is NaN).
+SanitizeReport sanitize_rpm(const double* in, std::size_t count, double sample_seconds,
+                            const SanitizeLimits& limits, double* out, std::uint8_t* flags,
+                            double previous_rpm = std::numeric_limits<double>::quiet_NaN())
+{
+    // Pass 1: finite/negative/range flags and clamping, no loop-carried state.
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        double v = in[i];
+        flags[i] = sanitize_rpm_value(v, limits.max_rpm);
+        out[i] = v;
+    }
+
+    // Pass 2: slew against the last clean sample, allowing for the time since
+    // it, so a rejected reading neither flags its successor nor locks the
+    // check onto a stale value. Comparisons with a NaN previous value are
+    // false, so the first sample passes when there is none.
+    const double max_step = limits.max_slew_rpm_per_sec * sample_seconds;
+    double previous = previous_rpm;
+    double steps = 1.0; // Sample intervals since `previous`.
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        flags[i] |= static_cast<std::uint8_t>(std::fabs(out[i] - previous) > max_step * steps ? SampleSlew : 0);
+        bool clean = flags[i] == SampleValid;
+        previous = clean ? out[i] : previous;
+        steps    = clean ? 1.0 : steps + 1.0;
+    }
+
+    SanitizeReport report;
+    report.samples = count;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        std::uint8_t f = flags[i];
+        report.valid      += (f == 0);
+        report.non_finite += (f & SampleNonFinite) != 0;
+        report.negative   += (f & SampleNegative) != 0;
+        report.over_range += (f & SampleOverRange) != 0;
+        report.slew       += (f & SampleSlew) != 0;
+    }
+    return report;
+}
+
+void print_sanitize_report(std::ostream& os, const SanitizeReport& report)
+{
+    os << "Samples: " << report.samples << " (" << report.valid << " valid)\n"
+       << "  non-finite " << report.non_finite << "\n"
+       << "  negative   " << report.negative << "\n"
+       << "  over-range " << report.over_range << "\n"
+       << "  slew       " << report.slew << "\n";
+}
+
+// -----------------------------------------------------------------------------
+// Band limits. A profile is the set of RPM thresholds one engine type (or a
+// derated engine) is classified against. Bands are contiguous, so a profile
+// only needs the lower edge of each band plus the top of RedLine, and the
+// band number is simply how many edges the RPM has reached.
+// -----------------------------------------------------------------------------
+struct BandProfile
+{
+    std::int32_t idle_min{ 1000 };
+    std::int32_t climb_min{ 3501 };
+    std::int32_t cruise_min{ 6001 };
+    std::int32_t caution_min{ 9001 };
+    std::int32_t redline_min{ 9800 };
+    std::int32_t redline_max{ 10200 };
+
+    static constexpr BandProfile standard() noexcept { return BandProfile{}; }
+
+    bool valid() const noexcept
+    {
+        return 0 < idle_min && idle_min < climb_min && climb_min < cruise_min
+            && cruise_min < caution_min && caution_min < redline_min && redline_min <= redline_max;
+    }
+
+    bool operator==(const BandProfile& o) const noexcept
+    {
+        return idle_min == o.idle_min && climb_min == o.climb_min && cruise_min == o.cruise_min
+            && caution_min == o.caution_min && redline_min == o.redline_min && redline_max == o.redline_max;
+    }
+
+    // The same profile with Caution and RedLine starting `rpm` lower (degraded engine).
+    BandProfile derated(std::int32_t rpm) const noexcept
+    {
+        BandProfile p = *this;
+        p.caution_min -= rpm;
+        p.redline_min -= rpm;
+        return p;
+    }
+
+    // Branch-free: PowerOff below idle (including 0), OverLimit above redline_max.
+    EnginePowerBand classify(int rpm) const noexcept
+    {
+        int band = (rpm >= idle_min) + (rpm >= climb_min) + (rpm >= cruise_min)
+                 + (rpm >= caution_min) + (rpm >= redline_min) + (rpm > redline_max);
+        return static_cast<EnginePowerBand>(band);
+    }
+};
+
+// Small deduplicated set of profiles referenced by index. Thresholds are kept
+// column-wise (one array per band edge) so a vector of profile indices can be
+// turned into a vector of thresholds with one gather per edge. The table is
+// plain data so it can be stored in the fleet state file as is.
+struct BandProfileTable
+{
+    static constexpr std::size_t k_max_profiles = 64;
+    static constexpr std::size_t k_edges        = 6;
+
+    std::uint32_t count{ 0 };
+    std::int32_t  edges[k_edges][k_max_profiles]{}; // edges[5] holds redline_max + 1.
 
+    // Returns the index of `profile`, adding it if new; -1 if the table is full.
+    int add(const BandProfile& profile) noexcept
+    {
+        for (std::uint32_t i = 0; i < count; ++i)
+            if (get(i) == profile)
+                return static_cast<int>(i);
+        if (count == k_max_profiles)
+            return -1;
+        edges[0][count] = profile.idle_min;
+        edges[1][count] = profile.climb_min;
+        edges[2][count] = profile.cruise_min;
+        edges[3][count] = profile.caution_min;
+        edges[4][count] = profile.redline_min;
+        edges[5][count] = profile.redline_max + 1;
+        return static_cast<int>(count++);
+    }
+
+    BandProfile get(std::size_t index) const noexcept
+    {
+        BandProfile p;
+        p.idle_min    = edges[0][index];
+        p.climb_min   = edges[1][index];
+        p.cruise_min  = edges[2][index];
+        p.caution_min = edges[3][index];
+        p.redline_min = edges[4][index];
+        p.redline_max = edges[5][index] - 1;
+        return p;
+    }
+
+    static BandProfileTable standard() noexcept
+    {
+        BandProfileTable table;
+        table.add(BandProfile::standard());
+        return table;
+    }
+};
+
+// Classify `count` filtered RPM values, each against the profile named by
+// profile_index[i]. With AVX2 eight engines are done per step using one
+// gather per band edge; the scalar loop handles the tail and other targets.
+// Optional derate[i] lowers the Caution and RedLine edges of engine i.
+void classify_rpm_gathered(const std::int32_t* rpm, const std::uint16_t* profile_index,
+                           const BandProfileTable& table, EnginePowerBand* bands, std::size_t count,
+                           const std::int32_t* derate = nullptr)
+{
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i r   = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rpm + i));
+        __m256i idx = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(profile_index + i)));
+        __m256i d   = derate ? _mm256_loadu_si256(reinterpret_cast<const __m256i*>(derate + i)) : _mm256_setzero_si256();
+        __m256i band = _mm256_set1_epi32(static_cast<int>(BandProfileTable::k_edges));
+        for (std::size_t e = 0; e < BandProfileTable::k_edges; ++e)
+        {
+            __m256i edge = _mm256_i32gather_epi32(table.edges[e], idx, 4);
+            if (e == 3 || e == 4)
+                edge = _mm256_sub_epi32(edge, d);
+            band = _mm256_add_epi32(band, _mm256_cmpgt_epi32(edge, r)); // -1 for each edge not reached
+        }
+        alignas(32) std::int32_t lanes[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), band);
+        for (int k = 0; k < 8; ++k)
+            bands[i + k] = static_cast<EnginePowerBand>(lanes[k]);
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        std::size_t  p = profile_index[i];
+        std::int32_t d = derate ? derate[i] : 0;
+        int band = 0;
+        for (std::size_t e = 0; e < BandProfileTable::k_edges; ++e)
+            band += rpm[i] >= table.edges[e][p] - ((e == 3 || e == 4) ? d : 0);
+        bands[i] = static_cast<EnginePowerBand>(band);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Degradation: time at RedLine and OverLimit accumulates damage (in equivalent
+// RedLine hours, OverLimit weighted higher) and damage lowers the engine's
+// Caution and RedLine thresholds by a common RPM derate. Overhaul clears the
+// damage, which restores the profile limits. The model is off by default.
+// -----------------------------------------------------------------------------
+struct DegradationModel
+{
+    float        redline_weight{ 1.0f };      // Damage hours per hour at RedLine.
+    float        overlimit_weight{ 4.0f };    // Damage hours per hour at OverLimit.
+    float        derate_rpm_per_hour{ 0.0f }; // Threshold drop per damage hour; 0 = disabled.
+    std::int32_t max_derate_rpm{ 800 };
+
+    bool enabled() const noexcept { return derate_rpm_per_hour > 0.0f && max_derate_rpm > 0; }
+
+    std::int32_t derate(float damage_hours) const noexcept
+    {
+        return static_cast<std::int32_t>(std::min(damage_hours * derate_rpm_per_hour, static_cast<float>(max_derate_rpm)));
+    }
+};
+
+// Largest derate that keeps every profile in `table` ordered (Caution above Cruise).
+std::int32_t max_safe_derate(const BandProfileTable& table) noexcept
+{
+    std::int32_t limit = std::numeric_limits<std::int32_t>::max();
+    for (std::uint32_t p = 0; p < table.count; ++p)
+        limit = std::min(limit, table.edges[3][p] - table.edges[2][p] - 1);
+    return std::max(limit, 0);
+}
+
+// Books one tick of `delta_seconds` of damage for `count` engines from the
+// bands they were just classified into, and refreshes their derates. Samples
+// not flagged SampleValid were clamped, so their band says nothing about the
+// engine and they add no damage. Arrays are per field (SoA) and the update is
+// compare-and-mask, eight engines per step with AVX2; both paths round
+// identically.
+void update_degradation(const EnginePowerBand* bands, const std::uint8_t* flags, float* damage,
+                        std::int32_t* derate, std::size_t count, double delta_seconds,
+                        const DegradationModel& model)
+{
+    const float hours     = static_cast<float>(delta_seconds / 3600.0);
+    const float redline   = model.redline_weight * hours;
+    const float overlimit = model.overlimit_weight * hours;
+
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i band_redline   = _mm256_set1_epi32(static_cast<int>(EnginePowerBand::RedLine));
+    const __m256i band_overlimit = _mm256_set1_epi32(static_cast<int>(EnginePowerBand::OverLimit));
+    const __m256  add_redline    = _mm256_set1_ps(redline);
+    const __m256  add_overlimit  = _mm256_set1_ps(overlimit);
+    const __m256  rate           = _mm256_set1_ps(model.derate_rpm_per_hour);
+    const __m256  max_derate     = _mm256_set1_ps(static_cast<float>(model.max_derate_rpm));
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i b = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bands + i)));
+        __m256i f = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(flags + i)));
+        __m256 valid = _mm256_castsi256_ps(_mm256_cmpeq_epi32(f, _mm256_setzero_si256()));
+        __m256 add = _mm256_and_ps(valid, _mm256_or_ps(
+            _mm256_and_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(b, band_redline)), add_redline),
+            _mm256_and_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(b, band_overlimit)), add_overlimit)));
+        __m256 dmg = _mm256_add_ps(_mm256_loadu_ps(damage + i), add);
+        _mm256_storeu_ps(damage + i, dmg);
+        __m256i d = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_mul_ps(dmg, rate), max_derate));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(derate + i), d);
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        float add = (bands[i] == EnginePowerBand::RedLine ? redline : 0.0f)
+                  + (bands[i] == EnginePowerBand::OverLimit ? overlimit : 0.0f);
+        damage[i] += flags[i] == SampleValid ? add : 0.0f;
+        derate[i] = model.derate(damage[i]);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Core Tachometer engine logic
+// -----------------------------------------------------------------------------
+class EnginePowerModel
+{
+private:
     static constexpr double k_pi = 3.141592653589793;
 
     double          m_raw_rpm{};
     int             m_filtered_rpm{};
     EnginePowerBand m_powerband{ EnginePowerBand::PowerOff };
+    bool            m_verbose{ true }; // Print band messages on every update.
+    std::uint8_t    m_sample_flags{ SampleValid };
 
 public:
-    void update_from_rpm(double angular_speed_rad_per_sec)
+    static constexpr double Sensor_max_rpm = 20000.0; // Plausible sensor range, see SanitizeLimits.
+
+    static double rpm_from_omega(double angular_speed_rad_per_sec) noexcept
+    {
+        return (angular_speed_rad_per_sec * 60.0) / (2.0 * k_pi);
+    }
+
+    // Band limits come from the engine's profile; the default is the standard engine.
+    void update_from_rpm(double angular_speed_rad_per_sec,
+                         const BandProfile& profile = BandProfile::standard())
     {
         // Convert angular speed (radians per second) to RPM.
-        double rpm_value = (angular_speed_rad_per_sec * 60.0) / (2.0 * k_pi);
+        double rpm_value = rpm_from_omega(angular_speed_rad_per_sec);
         m_raw_rpm = rpm_value;
-        m_filtered_rpm = static_cast<int>(std::lround(m_raw_rpm));
+
+        // NaN/Inf/negative input must never reach lround; clamp and remember why.
+        m_sample_flags = sanitize_rpm_value(rpm_value, Sensor_max_rpm);
+        m_filtered_rpm = static_cast<int>(std::lround(rpm_value));
+        if (m_sample_flags != SampleValid && m_verbose)
+            std::cout << "Sensor fault: sample rejected (flags " << int(m_sample_flags) << ").\n";
 
         // Classify into bands
-        if (m_filtered_rpm == 0)
-        {
-            m_powerband = EnginePowerBand::PowerOff;
-        }
-        else if (m_filtered_rpm < Idle_min)
+        m_powerband = profile.classify(m_filtered_rpm);
+        if (m_verbose)
+            print_band_message();
+    }
+
+    // Bulk paths convert and classify whole spans themselves, then store the result here.
+    void load_sample(double raw_rpm, int filtered_rpm, EnginePowerBand band, std::uint8_t flags) noexcept
+    {
+        m_raw_rpm      = raw_rpm;
+        m_filtered_rpm = filtered_rpm;
+        m_powerband    = band;
+        m_sample_flags = flags;
+    }
+
+    void print_band_message() const
+    {
+        switch (m_powerband)
         {
+        case EnginePowerBand::PowerOff:
             // Below idle: engine is spinning but not yet in normal band.
-            m_powerband = EnginePowerBand::PowerOff;
-            std::cout << "RPM Below Idle: Engine not in normal operating band.\n";
-        }
-        else if (m_filtered_rpm >= Idle_min && m_filtered_rpm <= Idle_max)
-        {
-            m_powerband = EnginePowerBand::Idle;
-            std::cout << "Idle: Value is within range.\n";
-        }
-        else if (m_filtered_rpm >= Climb_min && m_filtered_rpm <= Climb_max)
-        {
-            m_powerband = EnginePowerBand::Climb;
-            std::cout << "Climb: Value is within range.\n";
-        }
-        else if (m_filtered_rpm >= Cruise_min && m_filtered_rpm <= Cruise_max)
-        {
-            m_powerband = EnginePowerBand::Cruise;
-            std::cout << "Cruise: Value is within range.\n";
-        }
-        else if (m_filtered_rpm >= Caution_min && m_filtered_rpm <= Caution_max)
-        {
-            m_powerband = EnginePowerBand::Caution;
-            std::cout << "Caution: Engine is reaching Redline.\n";
-        }
-        else if (m_filtered_rpm >= RedLine_min && m_filtered_rpm <= RedLine_max)
-        {
-            m_powerband = EnginePowerBand::RedLine;
-            std::cout << "Warning: Engine may overheat.\n";
-        }
-        else // m_filtered_rpm > RedLine_max
-        {
-            m_powerband = EnginePowerBand::OverLimit;
-            std::cout << "WARNING: RPM ABOVE Defined RedLine (OverLimit).\n";
+            if (m_filtered_rpm != 0)
+                std::cout << "RPM Below Idle: Engine not in normal operating band.\n";
+            break;
+        case EnginePowerBand::Idle:      std::cout << "Idle: Value is within range.\n"; break;
+        case EnginePowerBand::Climb:     std::cout << "Climb: Value is within range.\n"; break;
+        case EnginePowerBand::Cruise:    std::cout << "Cruise: Value is within range.\n"; break;
+        case EnginePowerBand::Caution:   std::cout << "Caution: Engine is reaching Redline.\n"; break;
+        case EnginePowerBand::RedLine:   std::cout << "Warning: Engine may overheat.\n"; break;
+        case EnginePowerBand::OverLimit: std::cout << "WARNING: RPM ABOVE Defined RedLine (OverLimit).\n"; break;
         }
     }
 
@@ -126,6 +690,12 @@ public:
     EnginePowerBand powerband() const noexcept { return m_powerband; }
     bool isPowerOff() const noexcept         { return m_powerband == EnginePowerBand::PowerOff; }
     double raw_rpm() const noexcept          { return m_raw_rpm; }
+    std::uint8_t sample_flags() const noexcept { return m_sample_flags; }
+    bool sample_valid() const noexcept       { return m_sample_flags == SampleValid; }
+
+    // Band messages flood stdout at high sample rates; batch modes turn them off.
+    void set_verbose(bool verbose) noexcept  { m_verbose = verbose; }
+    bool verbose() const noexcept            { return m_verbose; }
 };
 
 // -----------------------------------------------------------------------------
@@ -171,10 +741,79 @@ public:
     {
     }
 
+    explicit RPMSource(std::uint32_t seed)
+        : rng(seed)
+    {
+    }
+
+    // Antithetic stream: every uniform u is used as 1 - u. Two sources on the
+    // same seed, one of them antithetic, give negatively correlated paths.
+    void set_antithetic(bool on) noexcept { antithetic = on; }
+
+    // Replaces band_probability with relative weights (PowerOff..OverLimit);
+    // an all-zero mix is ignored.
+    void set_band_mix(const double (&mix)[7]) noexcept
+    {
+        double total = 0.0;
+        for (double w : mix)
+            total += w;
+        if (!(total > 0.0))
+            return;
+        double acc = 0.0;
+        for (int b = 0; b < 6; ++b)
+            band_cumulative[b] = (acc += mix[b]) / total;
+    }
+
+    // Probability of each band (PowerOff..OverLimit) per next_omega() draw,
+    // and the RPM range drawn uniformly within it.
+    static constexpr double band_probability[7] = { 0.05, 0.15, 0.25, 0.35, 0.12, 0.06, 0.02 };
+    static constexpr double band_rpm_min[7]     = { 0.0, 1000.0, 3501.0, 6001.0, 9001.0, 9800.0, 10201.0 };
+    static constexpr double band_rpm_max[7]     = { 900.0, 3500.0, 6000.0, 9000.0, 9799.0, 10200.0, 11000.0 };
+
+    // Probability that one draw lands in each band of `profile` once rounded to
+    // whole RPM. Equals band_probability for the standard profile.
+    static void band_probabilities(const BandProfile& profile, double (&out)[7])
+    {
+        const double edges[6] = { double(profile.idle_min), double(profile.climb_min), double(profile.cruise_min),
+                                  double(profile.caution_min), double(profile.redline_min),
+                                  double(profile.redline_max) + 1.0 };
+        for (double& p : out)
+            p = 0.0;
+        for (int s = 0; s < 7; ++s)
+        {
+            // Share of the uniform draw that rounds to at least `edge`.
+            auto above = [&](double edge) {
+                double share = (band_rpm_max[s] - (edge - 0.5)) / (band_rpm_max[s] - band_rpm_min[s]);
+                return std::min(1.0, std::max(0.0, share));
+            };
+            double previous = 1.0;
+            for (int b = 0; b < 6; ++b)
+            {
+                double next = above(edges[b]);
+                out[b] += band_probability[s] * (previous - next);
+                previous = next;
+            }
+            out[6] += band_probability[s] * previous;
+        }
+    }
+
     void drive_engine(EnginePowerModel& engine)
+    {
+        double omega = next_omega();
+
+        engine.update_from_rpm(omega);
+
+        if (engine.verbose())
+            std::cout << "RPMSource drove engine with rpm = "
+                      << engine.filtered_rpm()
+                      << ", omega = " << omega << '\n';
+    }
+
+    // Draw the next angular speed (rad/s) without touching an engine.
+    double next_omega()
     {
         // We first choose a band probabilistically, then sample RPM in that band.
-        // Probabilities (can be tuned):
+        // Default probabilities (set_band_mix replaces them):
         //  5%  Below idle
         // 15%  Idle
         // 25%  Climb
@@ -184,92 +823,183 @@ public:
         //  2%  OverLimit
         std::uniform_real_distribution<double> pick_band(0.0, 1.0);
         double p = pick_band(rng);
+        if (antithetic)
+            p = 1.0 - p;
 
-        double rpm_min = 0.0;
-        double rpm_max = 0.0;
-
-        if (p < 0.05) // Below idle
-        {
-            rpm_min = 0.0;
-            rpm_max = 900.0;
-        }
-        else if (p < 0.20) // Idle band
-        {
-            rpm_min = 1000.0;
-            rpm_max = 3500.0;
-        }
-        else if (p < 0.45) // Climb
-        {
-            rpm_min = 3501.0;
-            rpm_max = 6000.0;
-        }
-        else if (p < 0.80) // Cruise
-        {
-            rpm_min = 6001.0;
-            rpm_max = 9000.0;
-        }
-        else if (p < 0.92) // Caution
-        {
-            rpm_min = 9001.0;
-            rpm_max = 9799.0;
-        }
-        else if (p < 0.98) // RedLine
-        {
-            rpm_min = 9800.0;
-            rpm_max = 10200.0;
-        }
-        else // OverLimit
-        {
-            rpm_min = 10201.0;
-            rpm_max = 11000.0;
-        }
+        int band = 0;
+        while (band < 6 && p >= band_cumulative[band])
+            ++band;
+        double rpm_min = band_rpm_min[band];
+        double rpm_max = band_rpm_max[band];
 
         std::uniform_real_distribution<double> rpm_dist(rpm_min, rpm_max);
         double rpm = rpm_dist(rng);
+        if (antithetic)
+            rpm = rpm_min + rpm_max - rpm; // Mirror within the band.
 
         // Convert RPM to angular speed (rad/s) for the engine
         constexpr double pi = 3.141592653589793;
-        double omega = (rpm * 2.0 * pi) / 60.0;
-
-        engine.update_from_rpm(omega);
-
-        std::cout << "RPMSource drove engine with rpm = "
-                  << engine.filtered_rpm()
-                  << ", omega = " << omega << '\n';
+        return (rpm * 2.0 * pi) / 60.0;
     }
 
 private:
     std::mt19937 rng;
+    bool         antithetic{ false };
+    // Upper edge of each band's share of [0, 1); OverLimit takes the rest.
+    double       band_cumulative[6]{ 0.05, 0.20, 0.45, 0.80, 0.92, 0.98 };
 };
 
 // -----------------------------------------------------------------------------
-// Diagnostic status
+// Mean-reverting RPM source: RPM follows an Ornstein-Uhlenbeck process
+//     dX = theta (mu - X) dt + sigma dW
+// whose setpoint mu steps through a repeating flight of mission phases. Each
+// step draws from the exact transition distribution
+//     X(t+h) | X(t) ~ N(mu + (X(t) - mu) e^(-theta h), s^2 (1 - e^(-2 theta h)))
+// (s = stationary std dev), split at phase boundaries, so a 10-minute tick is
+// as correct as a 1-second one.
 // -----------------------------------------------------------------------------
-enum class Diagnostic_Status {
-    SystemSuccessful,
-    SystemMaintenanceRequired,
-    SystemCheckSystemFailure
+struct MissionPhase
+{
+    std::string name;
+    double      seconds{ 0.0 };
+    double      setpoint_rpm{ 0.0 };
 };
 
-class Tachometer_Diagnostic {
+class MeanRevertingRPMSource
+{
 public:
-    Tachometer_Diagnostic()
-        : status_{ Diagnostic_Status::SystemSuccessful },
-          message_{ "SYSTEM CHECK: SUCCESSFUL" },
-          code_{ 0 }
+    struct Params
     {
-    }
+        double tau_seconds{ 60.0 };  // 1 / theta: time to close ~63% of a setpoint gap.
+        double stationary_sd{ 250.0 }; // RPM spread around a held setpoint.
+    };
 
-    Tachometer_Diagnostic(Diagnostic_Status status,
-                          std::string message,
-                          int code)
-        : status_{ status },
-          message_{ std::move(message) },
-          code_{ code }
+    // Ground, taxi, takeoff, climb, cruise, descent, approach, taxi-in.
+    static std::vector<MissionPhase> default_phases()
     {
+        return { { "shutdown", 30 * 60.0, 0.0 },    { "taxi", 10 * 60.0, 2000.0 },
+                 { "takeoff", 2 * 60.0, 9500.0 },   { "climb", 20 * 60.0, 8600.0 },
+                 { "cruise", 180 * 60.0, 7400.0 },  { "descent", 25 * 60.0, 4500.0 },
+                 { "approach", 8 * 60.0, 3000.0 },  { "taxi-in", 8 * 60.0, 1800.0 } };
     }
 
-    static Tachometer_Diagnostic successful(std::string msg = "SYSTEM CHECK: SUCCESSFUL", int code = 0)
+    // "name:minutes:rpm,..." in flight order.
+    static bool parse_phases(const std::string& text, std::vector<MissionPhase>& out)
+    {
+        std::vector<MissionPhase> phases;
+        std::stringstream in{ text };
+        std::string item;
+        while (std::getline(in, item, ','))
+        {
+            std::size_t a = item.find(':');
+            std::size_t b = a == std::string::npos ? a : item.find(':', a + 1);
+            if (a == 0 || b == std::string::npos)
+                return false;
+            char* end_minutes = nullptr;
+            char* end_rpm = nullptr;
+            MissionPhase phase{ item.substr(0, a), 60.0 * std::strtod(item.c_str() + a + 1, &end_minutes),
+                                std::strtod(item.c_str() + b + 1, &end_rpm) };
+            if (end_minutes != item.c_str() + b || *end_rpm != '\0' || !(phase.seconds > 0.0)
+                || !(phase.setpoint_rpm >= 0.0))
+                return false;
+            phases.push_back(phase);
+        }
+        if (phases.empty())
+            return false;
+        out = phases;
+        return true;
+    }
+
+    MeanRevertingRPMSource(std::uint32_t seed, const Params& params,
+                           std::vector<MissionPhase> phases = default_phases())
+        : rng_(seed), params_(params), phases_(std::move(phases))
+    {
+        params_.tau_seconds = std::max(params_.tau_seconds, 1e-3);
+        rpm_ = phases_.front().setpoint_rpm;
+    }
+
+    void drive_engine(EnginePowerModel& engine, double delta_seconds)
+    {
+        double omega = next_omega(delta_seconds);
+
+        engine.update_from_rpm(omega);
+
+        if (engine.verbose())
+            std::cout << "MeanRevertingRPMSource (" << phase().name << ") drove engine with rpm = "
+                      << engine.filtered_rpm() << ", omega = " << omega << '\n';
+    }
+
+    // Advance the process by delta_seconds and return the angular speed (rad/s)
+    // at the end of the step. The state is not clamped; only the reading is,
+    // since a spun-down engine cannot turn backwards.
+    double next_omega(double delta_seconds)
+    {
+        double left = std::max(delta_seconds, 0.0);
+        while (left > 0.0)
+        {
+            double h = std::min(left, phases_[phase_].seconds - in_phase_);
+            step(phases_[phase_].setpoint_rpm, h);
+            left -= h;
+            in_phase_ += h;
+            if (in_phase_ >= phases_[phase_].seconds)
+            {
+                in_phase_ = 0.0;
+                phase_ = (phase_ + 1) % phases_.size();
+            }
+        }
+        constexpr double pi = 3.141592653589793;
+        return (std::max(rpm_, 0.0) * 2.0 * pi) / 60.0;
+    }
+
+    const MissionPhase& phase() const { return phases_[phase_]; }
+    double rpm() const { return rpm_; }
+
+private:
+    void step(double setpoint, double h)
+    {
+        double decay = std::exp(-h / params_.tau_seconds);
+        // 1 - e^(-2h/tau) without cancellation for small steps.
+        double spread = params_.stationary_sd * std::sqrt(-std::expm1(-2.0 * h / params_.tau_seconds));
+        rpm_ = setpoint + (rpm_ - setpoint) * decay + spread * normal_(rng_);
+    }
+
+    std::mt19937                     rng_;
+    std::normal_distribution<double> normal_{ 0.0, 1.0 };
+    Params                           params_;
+    std::vector<MissionPhase>        phases_;
+    std::size_t                      phase_{ 0 };
+    double                           in_phase_{ 0.0 };
+    double                           rpm_{ 0.0 };
+};
+
+// -----------------------------------------------------------------------------
+// Diagnostic status
+// -----------------------------------------------------------------------------
+enum class Diagnostic_Status {
+    SystemSuccessful,
+    SystemMaintenanceRequired,
+    SystemCheckSystemFailure
+};
+
+class Tachometer_Diagnostic {
+public:
+    Tachometer_Diagnostic()
+        : status_{ Diagnostic_Status::SystemSuccessful },
+          message_{ "SYSTEM CHECK: SUCCESSFUL" },
+          code_{ 0 }
+    {
+    }
+
+    Tachometer_Diagnostic(Diagnostic_Status status,
+                          std::string message,
+                          int code)
+        : status_{ status },
+          message_{ std::move(message) },
+          code_{ code }
+    {
+    }
+
+    static Tachometer_Diagnostic successful(std::string msg = "SYSTEM CHECK: SUCCESSFUL", int code = 0)
     {
         return Tachometer_Diagnostic(Diagnostic_Status::SystemSuccessful, std::move(msg), code);
     }
@@ -297,6 +1027,46 @@ private:
 // -----------------------------------------------------------------------------
 // Flight hours logger
 // -----------------------------------------------------------------------------
+// Number of samples in each band, skipping those whose flag byte is not
+// SampleValid (flags may be null). AVX2 compares 16 bands per step against
+// every band value and keeps 16-bit lane counters, flushed before they wrap.
+void count_power_bands(const EnginePowerBand* bands, const std::uint8_t* flags, std::size_t n,
+                       std::uint64_t (&counts)[7])
+{
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    static_assert(sizeof(EnginePowerBand) == 2, "AVX2 path compares 16-bit bands");
+    const auto* lanes = reinterpret_cast<const std::uint16_t*>(bands);
+    constexpr std::size_t block = 16 * 4096; // Each lane counts at most 4096 per block.
+    while (i + 16 <= n)
+    {
+        __m256i acc[7];
+        for (__m256i& a : acc)
+            a = _mm256_setzero_si256();
+        const std::size_t stop = i + std::min(block, (n - i) / 16 * 16);
+        for (; i < stop; i += 16)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes + i));
+            __m256i valid = _mm256_set1_epi16(-1);
+            if (flags)
+                valid = _mm256_cvtepi8_epi16(_mm_cmpeq_epi8(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(flags + i)), _mm_setzero_si128()));
+            for (int b = 0; b < 7; ++b)
+                acc[b] = _mm256_sub_epi16(acc[b], _mm256_and_si256(valid, _mm256_cmpeq_epi16(v, _mm256_set1_epi16(b))));
+        }
+        for (int b = 0; b < 7; ++b)
+        {
+            alignas(32) std::int32_t sums[8];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(sums), _mm256_madd_epi16(acc[b], _mm256_set1_epi16(1)));
+            for (std::int32_t s : sums)
+                counts[b] += static_cast<std::uint64_t>(s);
+        }
+    }
+#endif
+    for (; i < n; ++i)
+        counts[static_cast<int>(bands[i])] += !flags || flags[i] == SampleValid;
+}
+
 class FlightHours
 {
 public:
@@ -304,32 +1074,56 @@ public:
     void flight_log_hours(const EnginePowerModel& engine, double delta_seconds)
     {
         EnginePowerBand band = engine.powerband();
-        int delta = static_cast<int>(std::lround(delta_seconds));
+        // Rejected sensor samples carry no band information: book no time for them.
+        // Rounded to the nearest second; the totals below are derived from the bands.
+        band_seconds[static_cast<int>(band)] += std::lround(delta_seconds) * static_cast<std::int64_t>(engine.sample_valid());
+    }
 
-        if (band != EnginePowerBand::PowerOff) // engine is running
-        {
-            total_seconds += delta; // Add this time to the total, rounded to nearest second.
-        }
+    // Books `seconds` spent in `band` in one step, as flight_log_hours() would
+    // for the same time split into ticks. Used where only per-band totals are known.
+    void add_band_seconds(EnginePowerBand band, std::int64_t seconds)
+    {
+        band_seconds[static_cast<int>(band)] += seconds;
+    }
 
-        if (band == EnginePowerBand::Caution)
-        {
-            caution_seconds += delta;
-        }
+    // Same totals as n flight_log_hours() calls of delta_seconds each, from the
+    // bands alone. Samples whose flag is not SampleValid book no time.
+    void flight_log_bands(const EnginePowerBand* bands, std::size_t n, double delta_seconds,
+                          const std::uint8_t* flags = nullptr)
+    {
+        std::uint64_t counts[7] = {};
+        count_power_bands(bands, flags, n, counts);
+        const std::int64_t delta = std::lround(delta_seconds);
+        for (int b = 0; b < 7; ++b)
+            add_band_seconds(static_cast<EnginePowerBand>(b), static_cast<std::int64_t>(counts[b]) * delta);
+    }
 
-        if (band == EnginePowerBand::RedLine || band == EnginePowerBand::OverLimit)
-        {
-            redline_seconds += delta;
-        }
+    // Per-sample deltas, each rounded like flight_log_hours(); give rejected samples 0.
+    void flight_log_bands(const EnginePowerBand* bands, const double* delta_seconds, std::size_t n)
+    {
+        std::int64_t seconds[7] = {};
+        for (std::size_t i = 0; i < n; ++i)
+            seconds[static_cast<int>(bands[i])] += std::lround(delta_seconds[i]);
+        for (int b = 0; b < 7; ++b)
+            add_band_seconds(static_cast<EnginePowerBand>(b), seconds[b]);
     }
 
     // Derived time components
-    int hours()   const noexcept { return total_seconds / 3600; }
-    int minutes() const noexcept { return (total_seconds % 3600) / 60; }
-    int seconds() const noexcept { return total_seconds % 60; }
+    std::int64_t hours()   const noexcept { return total_time() / 3600; }
+    int          minutes() const noexcept { return static_cast<int>((total_time() % 3600) / 60); }
+    int          seconds() const noexcept { return static_cast<int>(total_time() % 60); }
 
-    // Accessors for diagnostics
-    int caution_time() const noexcept { return caution_seconds; }
-    int redline_time() const noexcept { return redline_seconds; }
+    // Accessors for diagnostics; 64-bit, so years of simulated time cannot wrap.
+    std::int64_t total_time() const noexcept // Engine running: every band but PowerOff.
+    {
+        return band_seconds[1] + band_seconds[2] + band_seconds[3] + band_seconds[4] + band_seconds[5] + band_seconds[6];
+    }
+    std::int64_t caution_time() const noexcept { return band_time(EnginePowerBand::Caution); }
+    std::int64_t redline_time() const noexcept
+    {
+        return band_time(EnginePowerBand::RedLine) + band_time(EnginePowerBand::OverLimit);
+    }
+    std::int64_t band_time(EnginePowerBand band) const noexcept { return band_seconds[static_cast<int>(band)]; }
 
     // CSV Helper
     void csv_header(std::ostream& os) const
@@ -351,98 +1145,7315 @@ public:
         EnginePowerBand band = engine.powerband();
 
         os << time_step << ","
-           << total_seconds << ","
+           << total_time() << ","
            << hours() << ","
            << minutes() << ","
            << seconds() << ","
            << rpm << ","
            << to_string(band) << ","
-           << caution_seconds << ","
-           << redline_seconds << "\n";
+           << caution_time() << ","
+           << redline_time() << "\n";
+    }
+
+private:
+    std::int64_t band_seconds[7]{}; // Time per band, PowerOff..OverLimit.
+};
+
+// -----------------------------------------------------------------------------
+// Diagnostic policy (time spent in bad bands -> verdict)
+// -----------------------------------------------------------------------------
+struct DiagnosticPolicy
+{
+    static constexpr int one_minute = 60;
+    static constexpr int one_hour   = 60 * one_minute;
+
+    // Policy tuned for a ~50-hour run:
+    // - FAILURE:
+    //     more than 4 hours in redline / overlimit
+    // - MAINTENANCE REQUIRED:
+    //     redline between 1 and 4 hours, OR
+    //     caution more than 3 hours
+    // - SUCCESSFUL:
+    //     everything else
+    int failure_redline_sec     = 4 * one_hour;
+    int maintenance_redline_sec = 1 * one_hour;
+    int maintenance_caution_sec = 3 * one_hour;
+
+    Tachometer_Diagnostic evaluate(std::int64_t caution_sec, std::int64_t redline_sec) const
+    {
+        if (redline_sec > failure_redline_sec)
+        {
+            return Tachometer_Diagnostic::failure(
+                "SYSTEM CHECK: SYSTEM FAILURE - Excessive time in REDLINE/OVERLIMIT",
+                2
+            );
+        }
+        if (redline_sec > maintenance_redline_sec || caution_sec > maintenance_caution_sec)
+        {
+            return Tachometer_Diagnostic::maintenance(
+                "SYSTEM CHECK: MAINTENANCE REQUIRED - Heavy use in CAUTION/REDLINE bands",
+                1
+            );
+        }
+        return Tachometer_Diagnostic::successful(
+            "SYSTEM CHECK: SUCCESSFUL - Engine within expected use profile",
+            0
+        );
+    }
+
+    Tachometer_Diagnostic evaluate(const FlightHours& hours) const
+    {
+        return evaluate(hours.caution_time(), hours.redline_time());
+    }
+};
+
+// -----------------------------------------------------------------------------
+// Worker pool: fixed threads pulling tasks from a shared queue. Tasks receive
+// the index of the worker running them so callers can keep per-worker state.
+// -----------------------------------------------------------------------------
+class WorkerPool
+{
+public:
+    using Task = std::function<void(std::size_t worker)>;
+
+    explicit WorkerPool(std::size_t workers)
+    {
+        workers = std::max<std::size_t>(workers, 1);
+        threads_.reserve(workers);
+        for (std::size_t w = 0; w < workers; ++w)
+            threads_.emplace_back([this, w] { worker_loop(w); });
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        work_ready_.notify_all();
+        for (std::thread& t : threads_)
+            t.join();
+    }
+
+    std::size_t size() const noexcept { return threads_.size(); }
+
+    void submit(Task task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(std::move(task));
+            ++pending_;
+        }
+        work_ready_.notify_one();
+    }
+
+    // Blocks until every submitted task has finished.
+    void wait_idle()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [this] { return pending_ == 0; });
+    }
+
+    std::size_t queued() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return tasks_.size();
     }
 
 private:
-    int total_seconds{ 0 };   // total engine time reported in seconds.
-    int caution_seconds{ 0 }; // Time spent in caution band.
-    int redline_seconds{ 0 }; // Time spent in redline / over limit.
+    void worker_loop(std::size_t worker)
+    {
+        for (;;)
+        {
+            Task task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                work_ready_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+                if (tasks_.empty())
+                    return;
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            task(worker);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (--pending_ == 0)
+                    idle_.notify_all();
+            }
+        }
+    }
+
+    std::vector<std::thread> threads_;
+    std::deque<Task>         tasks_;
+    std::size_t              pending_{ 0 };
+    bool                     stopping_{ false };
+    mutable std::mutex       mutex_;
+    std::condition_variable  work_ready_;
+    std::condition_variable  idle_;
 };
 
 // -----------------------------------------------------------------------------
-// main
+// Terminal gauge display. The screen is modelled as two cell buffers: the
+// frame being drawn and what the terminal currently shows. present() emits
+// only the cells that differ (cursor jumps and colour changes only when
+// needed) and hands the whole frame to the terminal in a single write.
 // -----------------------------------------------------------------------------
-int main()
+enum class TermColor : std::uint8_t
+{
+    Default = 0,
+    Gray    = 90,
+    Red     = 31,
+    Green   = 32,
+    Yellow  = 33,
+    Cyan    = 36,
+    White   = 37
+};
+
+class TerminalScreen
+{
+public:
+    TerminalScreen(int width, int height)
+        : width_(width),
+          height_(height),
+          back_(static_cast<std::size_t>(width * height)),
+          front_(static_cast<std::size_t>(width * height), Cell{ '\0', TermColor::Default })
+    {
+        out_.reserve(static_cast<std::size_t>(width * height) * 8);
+    }
+
+    int width() const noexcept  { return width_; }
+    int height() const noexcept { return height_; }
+
+    void clear()
+    {
+        std::fill(back_.begin(), back_.end(), Cell{});
+    }
+
+    void put(int x, int y, char ch, TermColor color = TermColor::Default)
+    {
+        if (x >= 0 && y >= 0 && x < width_ && y < height_)
+            back_[static_cast<std::size_t>(y * width_ + x)] = Cell{ ch, color };
+    }
+
+    void text(int x, int y, const std::string& s, TermColor color = TermColor::Default)
+    {
+        for (std::size_t i = 0; i < s.size(); ++i)
+            put(x + static_cast<int>(i), y, s[i], color);
+    }
+
+    // Writes the changed cells to `fd`. Returns the bytes written this frame.
+    std::size_t present(int fd)
+    {
+        out_.clear();
+        int cursor_x = -1, cursor_y = -1;
+        TermColor color = TermColor::Default;
+        bool color_known = false;
+
+        for (int y = 0; y < height_; ++y)
+        {
+            for (int x = 0; x < width_; ++x)
+            {
+                std::size_t at = static_cast<std::size_t>(y * width_ + x);
+                const Cell& cell = back_[at];
+                if (cell == front_[at])
+                    continue;
+                if (cursor_x != x || cursor_y != y)
+                    out_ += "\x1b[" + std::to_string(y + 1) + ';' + std::to_string(x + 1) + 'H';
+                if (!color_known || cell.color != color)
+                {
+                    out_ += "\x1b[" + std::to_string(static_cast<int>(cell.color)) + 'm';
+                    color = cell.color;
+                    color_known = true;
+                }
+                out_ += cell.ch;
+                front_[at] = cell;
+                cursor_x = x + 1;
+                cursor_y = y;
+            }
+        }
+
+        if (!out_.empty())
+            write_exact_fd(fd, out_.data(), out_.size());
+        return out_.size();
+    }
+
+    // Writes all of p[0..n), retrying interrupted and partial writes; gives up on other errors.
+    static void write_exact_fd(int fd, const char* p, std::size_t n)
+    {
+        while (n > 0)
+        {
+            ssize_t w = ::write(fd, p, n);
+            if (w < 0 && errno == EINTR)
+                continue;
+            if (w <= 0)
+                return;
+            p += w;
+            n -= static_cast<std::size_t>(w);
+        }
+    }
+
+private:
+    struct Cell
+    {
+        char      ch{ ' ' };
+        TermColor color{ TermColor::Default };
+
+        bool operator==(const Cell& o) const noexcept { return ch == o.ch && color == o.color; }
+    };
+
+    int               width_;
+    int               height_;
+    std::vector<Cell> back_;
+    std::vector<Cell> front_;
+    std::string       out_;
+};
+
+TermColor band_color(EnginePowerBand band)
+{
+    switch (band)
+    {
+    case EnginePowerBand::PowerOff:  return TermColor::Gray;
+    case EnginePowerBand::Idle:      return TermColor::White;
+    case EnginePowerBand::Climb:
+    case EnginePowerBand::Cruise:    return TermColor::Green;
+    case EnginePowerBand::Caution:   return TermColor::Yellow;
+    case EnginePowerBand::RedLine:
+    case EnginePowerBand::OverLimit: return TermColor::Red;
+    }
+    return TermColor::Default;
+}
+
+// Analog tach: a 240-degree dial from 0 to gauge_max_rpm with the arc coloured
+// by band, a needle, and a digital readout. Terminal cells are about twice as
+// tall as wide, so the horizontal radius is doubled.
+void draw_tach_gauge(TerminalScreen& screen, int cx, int cy, int radius, int rpm, const BandProfile& profile)
+{
+    constexpr double gauge_max_rpm = 12000.0;
+    constexpr double pi = 3.141592653589793;
+    auto angle_of = [&](double value) {
+        double clamped = std::min(std::max(value, 0.0), gauge_max_rpm);
+        return (210.0 - 240.0 * clamped / gauge_max_rpm) * pi / 180.0;
+    };
+    auto point = [&](double angle, double r, int& x, int& y) {
+        x = cx + static_cast<int>(std::lround(2.0 * r * std::cos(angle)));
+        y = cy - static_cast<int>(std::lround(r * std::sin(angle)));
+    };
+
+    int x = 0, y = 0;
+    for (double value = 0.0; value <= gauge_max_rpm; value += 100.0)
+    {
+        point(angle_of(value), radius, x, y);
+        screen.put(x, y, '.', band_color(profile.classify(static_cast<int>(value))));
+    }
+    for (int k = 0; k <= 12; k += 2)
+    {
+        point(angle_of(k * 1000.0), radius + 1.5, x, y);
+        screen.text(x - (k >= 10 ? 1 : 0), y, std::to_string(k), TermColor::Cyan);
+    }
+
+    double needle = angle_of(rpm);
+    char stroke = '*';
+    double degrees = std::fmod(needle * 180.0 / pi + 360.0, 180.0);
+    if (degrees < 22.5 || degrees >= 157.5) stroke = '-';
+    else if (degrees < 67.5)                stroke = '/';
+    else if (degrees < 112.5)               stroke = '|';
+    else                                    stroke = '\\';
+    for (double r = 1.0; r < radius - 0.5; r += 0.5)
+    {
+        point(needle, r, x, y);
+        screen.put(x, y, stroke, band_color(profile.classify(rpm)));
+    }
+    screen.put(cx, cy, 'O', TermColor::White);
+    screen.text(cx - 4, cy - radius / 2 - 1, "x1000 RPM", TermColor::Cyan);
+
+    std::string readout = std::to_string(rpm);
+    readout = std::string(6 - std::min<std::size_t>(readout.size(), 6), ' ') + readout + " RPM";
+    screen.text(cx - 5, cy + radius / 2 + 3, readout, TermColor::White);
+}
+
+struct TuiConfig
+{
+    double duration_sec{ 10.0 };
+    double fps{ 60.0 };
+    double delta_seconds{ 1.0 }; // Simulated seconds per tick; the loop runs ~10M ticks/s.
+};
+
+volatile std::sig_atomic_t g_tui_interrupted = 0;
+
+// Runs the simulation flat out and redraws the gauge at the requested frame rate.
+int run_tui_mode(const TuiConfig& config)
 {
+    using clock = std::chrono::steady_clock;
+
     EnginePowerModel engine;
     FlightHours      flight_hours;
     RPMSource        rpm_source;
+    engine.set_verbose(false);
 
-    std::ofstream log_file{ "flight_log.csv" };
-    if (!log_file)
+    TerminalScreen screen(78, 20);
+    const int fd = STDOUT_FILENO;
+    const std::string enter = "\x1b[?1049h\x1b[?25l\x1b[2J";
+    const std::string leave = "\x1b[0m\x1b[?25h\x1b[?1049l";
+    TerminalScreen::write_exact_fd(fd, enter.data(), enter.size());
+    std::signal(SIGINT, [](int) { g_tui_interrupted = 1; });
+
+    const auto frame = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / config.fps));
+    const auto start = clock::now();
+    const auto stop = start + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(config.duration_sec));
+    auto next_frame = start;
+
+    std::uint64_t ticks = 0, frames = 0, bytes = 0;
+    while (!g_tui_interrupted)
     {
-        std::cerr << "Failed to open flight_log.csv\n";
-        return 1;
-    }
+        // Simulate until the next frame is due; check the clock every 1024 ticks.
+        do
+        {
+            EnginePowerBand bands[1024];
+            std::uint8_t    flags[1024];
+            for (int i = 0; i < 1024; ++i)
+            {
+                rpm_source.drive_engine(engine);
+                bands[i] = engine.powerband();
+                flags[i] = engine.sample_flags();
+            }
+            flight_hours.flight_log_bands(bands, 1024, config.delta_seconds, flags);
+            ticks += 1024;
+        } while (clock::now() < next_frame);
 
-    // Write header once
-    flight_hours.csv_header(log_file);
+        auto now = clock::now();
+        if (now >= stop)
+            break;
+        next_frame += frame;
+        if (next_frame < now)
+            next_frame = now + frame; // Fell behind: skip frames rather than burst.
 
-    // 50-hour endurance simulation, 1-minute resolution (easier to test diagnostics)
-const double delta_seconds = 60.0;        // 60 seconds (1 minute) per tick
-const int    total_ticks   = 50 * 60;     // 50 hours = 50 * 60 minutes
+        double elapsed = std::chrono::duration<double>(now - start).count();
+        EnginePowerBand band = engine.powerband();
 
+        screen.clear();
+        draw_tach_gauge(screen, 20, 11, 8, engine.filtered_rpm(), BandProfile::standard());
 
-    for (int tick = 0; tick < total_ticks; ++tick)
-    {
-        rpm_source.drive_engine(engine);                               // 1) random RPM across bands
-        flight_hours.flight_log_hours(engine, delta_seconds);          // 2) accumulate time by band
-        flight_hours.csv_row(log_file, engine, tick * delta_seconds);  // 3) CSV output
+        const int px = 44;
+        screen.text(px, 1, "JET ENGINE TACHOMETER", TermColor::Cyan);
+        std::string band_name = to_string(band);
+        screen.text(px, 3, "Band  [ " + band_name + std::string(10 - band_name.size(), ' ') + "]", band_color(band));
+
+        char line[64];
+        std::snprintf(line, sizeof(line), "Engine time  %5lld:%02d:%02d", static_cast<long long>(flight_hours.hours()),
+                      flight_hours.minutes(), flight_hours.seconds());
+        screen.text(px, 5, line);
+        std::snprintf(line, sizeof(line), "Caution      %10lld s", static_cast<long long>(flight_hours.caution_time()));
+        screen.text(px, 6, line, TermColor::Yellow);
+        std::snprintf(line, sizeof(line), "Redline/Over %10lld s", static_cast<long long>(flight_hours.redline_time()));
+        screen.text(px, 7, line, TermColor::Red);
+
+        Tachometer_Diagnostic diag = DiagnosticPolicy{}.evaluate(flight_hours);
+        screen.text(px, 9, "Status code " + std::to_string(diag.code()),
+                    diag.code() == 0 ? TermColor::Green : (diag.code() == 1 ? TermColor::Yellow : TermColor::Red));
+
+        std::snprintf(line, sizeof(line), "Ticks     %12llu", static_cast<unsigned long long>(ticks));
+        screen.text(px, 11, line, TermColor::Gray);
+        std::snprintf(line, sizeof(line), "Ticks/s   %12.0f", elapsed > 0.0 ? ticks / elapsed : 0.0);
+        screen.text(px, 12, line, TermColor::Gray);
+        std::snprintf(line, sizeof(line), "Frame     %12llu", static_cast<unsigned long long>(frames));
+        screen.text(px, 13, line, TermColor::Gray);
+        screen.text(px, 15, "Ctrl-C to quit", TermColor::Gray);
+
+        bytes += screen.present(fd);
+        ++frames;
     }
 
-     // -------------------------------------------------------------------------
-    // Diagnostics based on time spent in bad bands (NORMAL POLICY)
-    // -------------------------------------------------------------------------
-    int caution_sec = flight_hours.caution_time();
-    int redline_sec = flight_hours.redline_time();
+    TerminalScreen::write_exact_fd(fd, leave.data(), leave.size());
+    std::signal(SIGINT, SIG_DFL);
 
-    Tachometer_Diagnostic diag;
+    double elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    std::cout << "TUI: " << frames << " frames in " << elapsed << " s ("
+              << (elapsed > 0.0 ? frames / elapsed : 0.0) << " fps), "
+              << (frames > 0 ? bytes / frames : 0) << " bytes/frame, " << ticks << " ticks simulated\n";
+    Tachometer_Diagnostic diag = DiagnosticPolicy{}.evaluate(flight_hours);
+    std::cout << diag.message() << " (code " << diag.code() << ")\n";
+    return 0;
+}
 
-    const int one_minute = 60;
-    const int one_hour   = 60 * one_minute;
+// -----------------------------------------------------------------------------
+// CRC32C (Castagnoli) block checksums. On x86-64 CPUs with SSE4.2 the crc32
+// instruction consumes eight bytes per step, picked at run time so a plain
+// build uses it too; other CPUs use slicing-by-8 tables.
+// Logs are checksummed in fixed-size blocks while they are written and the
+// CRCs go to a "<log>.crc" sidecar, so the log stays a plain CSV and every
+// block can be verified on its own (and in parallel).
+// -----------------------------------------------------------------------------
+struct Crc32cTables
+{
+    std::uint32_t t[8][256];
 
-    // Policy tuned for a ~50-hour run:
-    // - FAILURE:
-    //     more than 4 hours in redline / overlimit
-    // - MAINTENANCE REQUIRED:
-    //     redline between 1 and 4 hours, OR
-    //     caution more than 3 hours
-    // - SUCCESSFUL:
-    //     everything else
-    if (redline_sec > 4 * one_hour)
+    Crc32cTables()
     {
-        diag = Tachometer_Diagnostic::failure(
-            "SYSTEM CHECK: SYSTEM FAILURE - Excessive time in REDLINE/OVERLIMIT",
-            2
-        );
+        for (std::uint32_t i = 0; i < 256; ++i)
+        {
+            std::uint32_t c = i;
+            for (int k = 0; k < 8; ++k)
+                c = (c >> 1) ^ (0x82F63B78u & (0u - (c & 1u)));
+            t[0][i] = c;
+        }
+        for (std::uint32_t i = 0; i < 256; ++i)
+            for (int s = 1; s < 8; ++s)
+                t[s][i] = (t[s - 1][i] >> 8) ^ t[0][t[s - 1][i] & 0xFF];
     }
-    else if (redline_sec > 1 * one_hour || caution_sec > 3 * one_hour)
+};
+
+#if defined(__x86_64__)
+// Kernels take and return the inverted CRC.
+__attribute__((target("sse4.2")))
+std::uint32_t crc32c_sse42(std::uint32_t c, const unsigned char* p, std::size_t n) noexcept
+{
+    std::uint64_t c64 = c;
+    for (; n >= 8; n -= 8, p += 8)
     {
-        diag = Tachometer_Diagnostic::maintenance(
-            "SYSTEM CHECK: MAINTENANCE REQUIRED - Heavy use in CAUTION/REDLINE bands",
-            1
-        );
+        std::uint64_t v;
+        std::memcpy(&v, p, sizeof(v));
+        c64 = _mm_crc32_u64(c64, v);
     }
-    else
+    c = static_cast<std::uint32_t>(c64);
+    for (; n > 0; --n)
+        c = _mm_crc32_u8(c, *p++);
+    return c;
+}
+#endif
+
+std::uint32_t crc32c_tables(std::uint32_t c, const unsigned char* p, std::size_t n) noexcept
+{
+    static const Crc32cTables tables;
+    const auto& t = tables.t;
+    for (; n >= 8; n -= 8, p += 8)
     {
-        diag = Tachometer_Diagnostic::successful(
-            "SYSTEM CHECK: SUCCESSFUL - Engine within expected use profile",
-            0
-        );
+        // Little-endian: the low four bytes absorb the running CRC.
+        std::uint32_t lo, hi;
+        std::memcpy(&lo, p, sizeof(lo));
+        std::memcpy(&hi, p + 4, sizeof(hi));
+        lo ^= c;
+        c = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24]
+          ^ t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
     }
+    for (; n > 0; --n)
+        c = t[0][(c ^ *p++) & 0xFF] ^ (c >> 8);
+    return c;
+}
+
+// Continues `crc` (0 for a fresh checksum) over `n` bytes.
+std::uint32_t crc32c(std::uint32_t crc, const void* data, std::size_t n) noexcept
+{
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+#if defined(__SSE4_2__)
+    return ~crc32c_sse42(~crc, p, n);
+#else
+#if defined(__x86_64__)
+    static const bool sse42 = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse4.2") != 0;
+    }();
+    if (sse42)
+        return ~crc32c_sse42(~crc, p, n);
+#endif
+    return ~crc32c_tables(~crc, p, n);
+#endif
+}
+
+struct ChecksumSidecarHeader
+{
+    char          magic[8];    // "TACHCRC"
+    std::uint32_t version;
+    std::uint32_t block_bytes;
+    std::uint64_t data_bytes;
+    std::uint64_t block_count;
+};
+// Followed by block_count CRCs and one CRC over everything before it.
+
+constexpr char          k_sidecar_magic[8]  = { 'T', 'A', 'C', 'H', 'C', 'R', 'C', '\0' };
+constexpr std::uint32_t k_sidecar_version   = 1;
+constexpr std::uint32_t k_checksum_block    = 1u << 16;
+
+inline std::string checksum_sidecar_path(const std::string& log_path) { return log_path + ".crc"; }
+
+// Streaming per-block CRCs over a byte stream fed in arbitrary pieces.
+class BlockChecksummer
+{
+public:
+    explicit BlockChecksummer(std::uint32_t block_bytes = k_checksum_block)
+        : block_bytes_{ block_bytes ? block_bytes : k_checksum_block }
+    {
+    }
+
+    void update(const char* p, std::size_t n) noexcept
+    {
+        while (n > 0)
+        {
+            std::size_t take = std::min<std::size_t>(n, block_bytes_ - used_);
+            crc_ = crc32c(crc_, p, take);
+            used_ += take;
+            total_ += take;
+            p += take;
+            n -= take;
+            if (used_ == block_bytes_)
+            {
+                crcs_.push_back(crc_);
+                crc_ = 0;
+                used_ = 0;
+            }
+        }
+    }
+
+    // Closes the final partial block; call once, after the last update().
+    void finish()
+    {
+        if (used_ > 0)
+            crcs_.push_back(crc_);
+        crc_ = 0;
+        used_ = 0;
+    }
+
+    bool write_sidecar(const std::string& log_path, std::string& error) const
+    {
+        ChecksumSidecarHeader header{};
+        std::memcpy(header.magic, k_sidecar_magic, sizeof(header.magic));
+        header.version     = k_sidecar_version;
+        header.block_bytes = block_bytes_;
+        header.data_bytes  = total_;
+        header.block_count = crcs_.size();
+
+        std::string bytes(reinterpret_cast<const char*>(&header), sizeof(header));
+        bytes.append(reinterpret_cast<const char*>(crcs_.data()), crcs_.size() * sizeof(std::uint32_t));
+        std::uint32_t trailer = crc32c(0, bytes.data(), bytes.size());
+        bytes.append(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+
+        std::string path = checksum_sidecar_path(log_path);
+        std::ofstream out{ path, std::ios::binary | std::ios::trunc };
+        if (!out.write(bytes.data(), static_cast<std::streamsize>(bytes.size())))
+        {
+            error = "cannot write " + path;
+            return false;
+        }
+        return true;
+    }
+
+    std::uint64_t bytes() const noexcept { return total_; }
+
+private:
+    std::uint32_t              block_bytes_;
+    std::uint32_t              crc_{ 0 };
+    std::size_t                used_{ 0 };
+    std::uint64_t              total_{ 0 };
+    std::vector<std::uint32_t> crcs_;
+};
+
+// Read-only mapping of a whole file.
+class MappedInput
+{
+public:
+    MappedInput() = default;
+    MappedInput(const MappedInput&) = delete;
+    MappedInput& operator=(const MappedInput&) = delete;
+    ~MappedInput()
+    {
+        if (data_ && size_)
+            ::munmap(const_cast<char*>(data_), size_);
+    }
+
+    bool open(const std::string& path, std::string& error)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            error = "cannot open " + path + ": " + std::strerror(errno);
+            return false;
+        }
+        struct stat st{};
+        if (::fstat(fd, &st) != 0)
+        {
+            error = "cannot stat " + path + ": " + std::strerror(errno);
+            ::close(fd);
+            return false;
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ > 0)
+        {
+            void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED)
+            {
+                error = "cannot map " + path + ": " + std::strerror(errno);
+                ::close(fd);
+                size_ = 0;
+                return false;
+            }
+            ::madvise(p, size_, MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(p);
+        }
+        ::close(fd);
+        return true;
+    }
+
+    const char* data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return size_; }
+
+private:
+    const char* data_{ nullptr };
+    std::size_t size_{ 0 };
+};
+
+struct BlockVerifyReport
+{
+    std::uint64_t              blocks{ 0 };
+    std::uint64_t              block_bytes{ 0 };
+    std::uint64_t              bytes{ 0 };
+    bool                       size_mismatch{ false };
+    std::vector<std::uint64_t> bad_blocks;
+
+    bool ok() const noexcept { return !size_mismatch && bad_blocks.empty(); }
+};
+
+// Checks `log_path` against its sidecar. Blocks are independent, so they are
+// spread over `threads` workers. Returns false only if the sidecar itself is
+// missing or unreadable (the message is in `error`); corruption is in `report`.
+bool verify_log_blocks(const std::string& log_path, std::size_t threads, BlockVerifyReport& report,
+                       std::string& error)
+{
+    MappedInput sidecar;
+    if (!sidecar.open(checksum_sidecar_path(log_path), error))
+        return false;
+    ChecksumSidecarHeader header{};
+    if (sidecar.size() < sizeof(header) + sizeof(std::uint32_t))
+    {
+        error = checksum_sidecar_path(log_path) + " is truncated";
+        return false;
+    }
+    std::memcpy(&header, sidecar.data(), sizeof(header));
+    std::size_t body = sizeof(header) + header.block_count * sizeof(std::uint32_t);
+    std::uint32_t trailer = 0;
+    if (std::memcmp(header.magic, k_sidecar_magic, sizeof(header.magic)) != 0 || header.version != k_sidecar_version
+        || header.block_bytes == 0 || sidecar.size() != body + sizeof(trailer))
+    {
+        error = checksum_sidecar_path(log_path) + " is not a checksum sidecar";
+        return false;
+    }
+    std::memcpy(&trailer, sidecar.data() + body, sizeof(trailer));
+    if (crc32c(0, sidecar.data(), body) != trailer)
+    {
+        error = checksum_sidecar_path(log_path) + " is corrupt";
+        return false;
+    }
+    const char* crc_bytes = sidecar.data() + sizeof(header);
+
+    MappedInput log;
+    if (!log.open(log_path, error))
+        return false;
+
+    report = BlockVerifyReport{};
+    report.blocks = header.block_count;
+    report.block_bytes = header.block_bytes;
+    report.bytes  = log.size();
+    std::uint64_t expected_blocks = (header.data_bytes + header.block_bytes - 1) / header.block_bytes;
+    report.size_mismatch = log.size() != header.data_bytes || expected_blocks != header.block_count;
+    std::uint64_t blocks = std::min<std::uint64_t>(header.block_count,
+                                                   (log.size() + header.block_bytes - 1) / header.block_bytes);
+
+    // Each worker takes a contiguous run of blocks and keeps its own bad list.
+    std::size_t workers = std::max<std::size_t>(1, std::min<std::uint64_t>(threads, blocks));
+    std::vector<std::vector<std::uint64_t>> bad(workers);
+    WorkerPool pool(workers);
+    for (std::size_t w = 0; w < workers; ++w)
+    {
+        pool.submit([&, w](std::size_t) {
+            std::uint64_t first = blocks * w / workers;
+            std::uint64_t last  = blocks * (w + 1) / workers;
+            for (std::uint64_t b = first; b < last; ++b)
+            {
+                std::size_t offset = static_cast<std::size_t>(b * header.block_bytes);
+                std::size_t length = std::min<std::size_t>(header.block_bytes, log.size() - offset);
+                std::uint32_t expected;
+                std::memcpy(&expected, crc_bytes + b * sizeof(expected), sizeof(expected));
+                if (crc32c(0, log.data() + offset, length) != expected)
+                    bad[w].push_back(b);
+            }
+        });
+    }
+    pool.wait_idle();
+    for (const auto& list : bad)
+        report.bad_blocks.insert(report.bad_blocks.end(), list.begin(), list.end());
+    return true;
+}
+
+// Output file that checksums its bytes block by block on the way out and
+// writes the sidecar when closed. Drop-in for std::ofstream in the writers.
+class ChecksummedFileBuf : public std::streambuf
+{
+public:
+    ChecksummedFileBuf(const std::string& path, std::uint32_t block_bytes)
+        : path_(path),
+          sums_(block_bytes),
+          buffer_(k_checksum_block)
+    {
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        setp(buffer_.data(), buffer_.data() + buffer_.size());
+    }
+
+    ~ChecksummedFileBuf() override
+    {
+        std::string error;
+        close(error);
+    }
+
+    bool is_open() const noexcept { return fd_ >= 0; }
+    std::uint64_t bytes_written() const noexcept { return sums_.bytes(); }
+
+    // Flushes, closes the file and writes the sidecar.
+    bool close(std::string& error)
+    {
+        if (fd_ < 0)
+            return ok_;
+        ok_ = drain() && ok_;
+        ::close(fd_);
+        fd_ = -1;
+        sums_.finish();
+        if (!ok_)
+        {
+            error = "write to " + path_ + " failed";
+            return false;
+        }
+        return ok_ = sums_.write_sidecar(path_, error);
+    }
+
+protected:
+    int_type overflow(int_type ch) override
+    {
+        if (!drain())
+            return traits_type::eof();
+        if (!traits_type::eq_int_type(ch, traits_type::eof()))
+        {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    int sync() override { return drain() ? 0 : -1; }
+
+private:
+    bool drain()
+    {
+        std::size_t n = static_cast<std::size_t>(pptr() - pbase());
+        const char* p = pbase();
+        sums_.update(p, n);
+        sim_metrics().bytes_written.add(n);
+        while (n > 0 && fd_ >= 0)
+        {
+            ssize_t w = ::write(fd_, p, n);
+            if (w < 0 && errno == EINTR)
+                continue;
+            if (w <= 0)
+            {
+                ok_ = false;
+                break;
+            }
+            p += w;
+            n -= static_cast<std::size_t>(w);
+        }
+        setp(buffer_.data(), buffer_.data() + buffer_.size());
+        return ok_;
+    }
+
+    std::string       path_;
+    BlockChecksummer  sums_;
+    std::vector<char> buffer_;
+    int               fd_{ -1 };
+    bool              ok_{ true };
+};
+
+class ChecksummedLogFile : private ChecksummedFileBuf, public std::ostream
+{
+public:
+    explicit ChecksummedLogFile(const std::string& path, std::uint32_t block_bytes = k_checksum_block)
+        : ChecksummedFileBuf(path, block_bytes),
+          std::ostream(static_cast<ChecksummedFileBuf*>(this))
+    {
+        if (!is_open())
+            setstate(std::ios::failbit);
+    }
+
+    bool close(std::string& error)
+    {
+        flush();
+        return ChecksummedFileBuf::close(error);
+    }
+
+    using ChecksummedFileBuf::bytes_written;
+};
+
+// -----------------------------------------------------------------------------
+// Run catalog: one entry per written log (run settings, per-band totals, max
+// RPM, verdict) so questions about a whole archive are answered without
+// reading the logs. The file is columnar and sorted by log path; writers
+// upsert their entry under an flock and replace the file atomically.
+// -----------------------------------------------------------------------------
+struct CatalogEntry
+{
+    std::string   path;
+    std::string   mode;              // "main", "replay", "generate".
+    std::string   config;            // Run settings as "key=value ..." text.
+    std::uint64_t seed{ 0 };
+    std::uint64_t rows{ 0 };
+    std::uint64_t bytes{ 0 };
+    double        delta_seconds{ 0.0 };
+    double        band_seconds[7]{}; // Booked time per EnginePowerBand.
+    double        max_rpm{ 0.0 };
+    int           verdict{ 0 };      // Tachometer_Diagnostic::code().
+};
+
+// Accumulates a catalog entry alongside the log rows.
+class CatalogRecorder
+{
+public:
+    void observe(EnginePowerBand band, double rpm, double booked_seconds) noexcept
+    {
+        band_seconds_[static_cast<int>(band)] += booked_seconds;
+        max_rpm_ = std::max(max_rpm_, rpm);
+        ++rows_;
+    }
+
+    void add_ticks(const std::uint64_t (&ticks)[7], std::uint64_t rows, double delta_seconds, double max_rpm) noexcept
+    {
+        for (int b = 0; b < 7; ++b)
+            band_seconds_[b] += static_cast<double>(ticks[b]) * delta_seconds;
+        max_rpm_ = std::max(max_rpm_, max_rpm);
+        rows_ += rows;
+    }
+
+    CatalogEntry entry(std::string path, std::string mode, std::string config, std::uint64_t seed,
+                       double delta_seconds, std::uint64_t bytes) const
+    {
+        CatalogEntry e;
+        e.path          = std::move(path);
+        e.mode          = std::move(mode);
+        e.config        = std::move(config);
+        e.seed          = seed;
+        e.rows          = rows_;
+        e.bytes         = bytes;
+        e.delta_seconds = delta_seconds;
+        std::copy(std::begin(band_seconds_), std::end(band_seconds_), std::begin(e.band_seconds));
+        e.max_rpm       = max_rpm_;
+
+        // Same verdict FlightHours would get for the same band totals.
+        e.verdict = DiagnosticPolicy{}.evaluate(std::llround(band_seconds_[4]),
+                                                std::llround(band_seconds_[5] + band_seconds_[6])).code();
+        return e;
+    }
+
+private:
+    double        band_seconds_[7]{};
+    double        max_rpm_{ 0.0 };
+    std::uint64_t rows_{ 0 };
+};
+
+class RunCatalog
+{
+public:
+    // Numeric columns, in file order after the string and seed columns.
+    enum Column : int
+    {
+        Rows, Bytes, Delta, Duration,
+        PowerOff, Idle, Climb, Cruise, Caution, RedLine, OverLimit,
+        MaxRpm, Verdict, Seed,
+        k_stored_columns = Seed // Seed is kept as uint64, not in columns_.
+    };
+
+    std::size_t size() const noexcept { return paths_.size(); }
+    const std::string& path(std::size_t i) const { return paths_[i]; }
+    const std::string& mode(std::size_t i) const { return modes_[i]; }
+
+    double value(Column c, std::size_t i) const
+    {
+        return c == Seed ? static_cast<double>(seeds_[i]) : columns_[c][i];
+    }
+
+    const double*        column(Column c) const { return columns_[c].data(); }
+    const std::uint64_t* seeds() const { return seeds_.data(); }
+
+    // Reads `file`; a missing file is an empty catalog. Any other open error
+    // fails, so a writer never replaces a catalog it could not read.
+    bool load(const std::string& file, std::string& error)
+    {
+        *this = RunCatalog{};
+        struct stat st{};
+        if (::stat(file.c_str(), &st) != 0)
+        {
+            if (errno == ENOENT)
+                return true;
+            error = "cannot open " + file + ": " + std::strerror(errno);
+            return false;
+        }
+        if (!S_ISREG(st.st_mode))
+        {
+            error = file + " is not a regular file";
+            return false;
+        }
+        errno = 0;
+        std::ifstream in{ file, std::ios::binary };
+        if (!in)
+        {
+            error = "cannot open " + file + ": " + std::strerror(errno ? errno : EIO);
+            return false;
+        }
+        std::string bytes{ std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+
+        std::string note;
+        if (!verify_image(bytes.data(), bytes.size(), note, error))
+        {
+            error = file + " is " + error;
+            return false;
+        }
+        Header h{};
+        std::memcpy(&h, bytes.data(), sizeof(h));
+        const std::size_t n = static_cast<std::size_t>(h.entries);
+
+        const char* p = bytes.data() + sizeof(h);
+        std::vector<std::uint32_t> offsets(3 * (n + 1));
+        std::memcpy(offsets.data(), p, offsets.size() * sizeof(std::uint32_t));
+        p += offsets.size() * sizeof(std::uint32_t);
+        const char* strings = p;
+        p += round8(h.string_bytes);
+        std::vector<std::string>* text[3] = { &paths_, &modes_, &configs_ };
+        for (int s = 0; s < 3; ++s)
+        {
+            const std::uint32_t* o = offsets.data() + s * (n + 1);
+            text[s]->reserve(n);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                if (o[i] > o[i + 1] || o[i + 1] > h.string_bytes)
+                {
+                    error = file + " is corrupt";
+                    *this = RunCatalog{};
+                    return false;
+                }
+                text[s]->emplace_back(strings + o[i], o[i + 1] - o[i]);
+            }
+        }
+        seeds_.resize(n);
+        std::memcpy(seeds_.data(), p, n * sizeof(std::uint64_t));
+        p += n * sizeof(std::uint64_t);
+        for (auto& column : columns_)
+        {
+            column.resize(n);
+            std::memcpy(column.data(), p, n * sizeof(double));
+            p += n * sizeof(double);
+        }
+        return true;
+    }
+
+    static bool is_image(const char* data, std::size_t size)
+    {
+        return size >= sizeof(k_magic) && std::memcmp(data, k_magic, sizeof(k_magic)) == 0;
+    }
+
+    // Checks a catalog image against its header and CRC32C trailer; the
+    // catalog needs no sidecar. On success `note` gives the entry count.
+    static bool verify_image(const char* data, std::size_t size, std::string& note, std::string& error)
+    {
+        Header h{};
+        std::uint32_t trailer = 0;
+        if (size < sizeof(h) + sizeof(trailer))
+        {
+            error = "truncated";
+            return false;
+        }
+        std::memcpy(&h, data, sizeof(h));
+        std::memcpy(&trailer, data + size - sizeof(trailer), sizeof(trailer));
+        if (!is_image(data, size) || h.version != k_version)
+        {
+            error = "not a run catalog for this build";
+            return false;
+        }
+        if (h.entries > size || h.string_bytes > size
+            || size != body_bytes(static_cast<std::size_t>(h.entries), h.string_bytes) + sizeof(trailer)
+            || crc32c(0, data, size - sizeof(trailer)) != trailer)
+        {
+            error = "corrupt";
+            return false;
+        }
+        note = std::to_string(h.entries) + " catalog entries";
+        return true;
+    }
+
+    // Inserts or replaces the entry for e.path, keeping paths sorted.
+    void upsert(const CatalogEntry& e)
+    {
+        auto it = std::lower_bound(paths_.begin(), paths_.end(), e.path);
+        std::size_t i = static_cast<std::size_t>(it - paths_.begin());
+        if (it == paths_.end() || *it != e.path)
+        {
+            paths_.insert(it, e.path);
+            modes_.insert(modes_.begin() + i, std::string{});
+            configs_.insert(configs_.begin() + i, std::string{});
+            seeds_.insert(seeds_.begin() + i, 0);
+            for (auto& column : columns_)
+                column.insert(column.begin() + i, 0.0);
+        }
+        modes_[i]   = e.mode;
+        configs_[i] = e.config;
+        seeds_[i]   = e.seed;
+        columns_[Rows][i]     = static_cast<double>(e.rows);
+        columns_[Bytes][i]    = static_cast<double>(e.bytes);
+        columns_[Delta][i]    = e.delta_seconds;
+        columns_[Duration][i] = static_cast<double>(e.rows) * e.delta_seconds;
+        for (int b = 0; b < 7; ++b)
+            columns_[PowerOff + b][i] = e.band_seconds[b];
+        columns_[MaxRpm][i]   = e.max_rpm;
+        columns_[Verdict][i]  = e.verdict;
+    }
+
+    bool save(const std::string& file, std::string& error) const
+    {
+        const std::size_t n = size();
+        std::vector<std::uint32_t> offsets;
+        std::string strings;
+        for (const std::vector<std::string>* text : { &paths_, &modes_, &configs_ })
+        {
+            for (const std::string& s : *text)
+            {
+                offsets.push_back(static_cast<std::uint32_t>(strings.size()));
+                strings += s;
+            }
+            offsets.push_back(static_cast<std::uint32_t>(strings.size()));
+        }
+
+        Header h{};
+        std::memcpy(h.magic, k_magic, sizeof(k_magic));
+        h.version      = k_version;
+        h.entries      = n;
+        h.string_bytes = strings.size();
+
+        std::string bytes;
+        bytes.reserve(body_bytes(n, strings.size()) + sizeof(std::uint32_t));
+        bytes.append(reinterpret_cast<const char*>(&h), sizeof(h));
+        bytes.append(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(std::uint32_t));
+        bytes += strings;
+        bytes.resize(bytes.size() + round8(strings.size()) - strings.size(), '\0');
+        bytes.append(reinterpret_cast<const char*>(seeds_.data()), n * sizeof(std::uint64_t));
+        for (const auto& column : columns_)
+            bytes.append(reinterpret_cast<const char*>(column.data()), n * sizeof(double));
+        std::uint32_t trailer = crc32c(0, bytes.data(), bytes.size());
+        bytes.append(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+
+        std::string tmp = file + ".tmp";
+        {
+            std::ofstream out{ tmp, std::ios::binary | std::ios::trunc };
+            if (!out.write(bytes.data(), static_cast<std::streamsize>(bytes.size())))
+            {
+                error = "cannot write " + tmp;
+                return false;
+            }
+        }
+        if (std::rename(tmp.c_str(), file.c_str()) != 0)
+        {
+            error = "cannot replace " + file + ": " + std::strerror(errno);
+            return false;
+        }
+        return true;
+    }
+
+private:
+    struct Header
+    {
+        char          magic[8];
+        std::uint32_t version;
+        std::uint32_t reserved;
+        std::uint64_t entries;
+        std::uint64_t string_bytes;
+    };
+    // Followed by path/mode/config offsets (entries + 1 each), the string bytes
+    // padded to 8, the seed column, the numeric columns and a CRC32C.
+
+    static constexpr char          k_magic[8] = { 'T', 'A', 'C', 'H', 'C', 'A', 'T', '\0' };
+    static constexpr std::uint32_t k_version  = 1;
+
+    static std::size_t round8(std::size_t n) { return (n + 7) & ~std::size_t{ 7 }; }
+
+    static std::size_t body_bytes(std::size_t n, std::size_t string_bytes)
+    {
+        return sizeof(Header) + 3 * (n + 1) * sizeof(std::uint32_t) + round8(string_bytes)
+             + n * sizeof(std::uint64_t) + k_stored_columns * n * sizeof(double);
+    }
+
+    std::vector<std::string>   paths_;
+    std::vector<std::string>   modes_;
+    std::vector<std::string>   configs_;
+    std::vector<std::uint64_t> seeds_;
+    std::vector<double>        columns_[k_stored_columns];
+};
+
+// Adds or refreshes one log's entry. Concurrent writers serialize on a lock file.
+bool record_catalog_entry(const std::string& catalog_path, const CatalogEntry& entry, std::string& error)
+{
+    std::string lock_path = catalog_path + ".lock";
+    int lock = ::open(lock_path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (lock < 0 || ::flock(lock, LOCK_EX) != 0)
+    {
+        error = "cannot lock " + lock_path + ": " + std::strerror(errno);
+        if (lock >= 0)
+            ::close(lock);
+        return false;
+    }
+    RunCatalog catalog;
+    bool ok = catalog.load(catalog_path, error);
+    if (ok)
+    {
+        catalog.upsert(entry);
+        ok = catalog.save(catalog_path, error);
+    }
+    ::close(lock); // Releases the flock.
+    return ok;
+}
+
+// Query: comparisons joined by "and", e.g. "overlimit > 0 and redline > 2h".
+// Time columns take s/m/h/d suffixes; verdict takes successful/maintenance/
+// failure; mode compares as text with = or !=.
+struct CatalogClause
+{
+    enum class Op { Lt, Le, Gt, Ge, Eq, Ne };
+    RunCatalog::Column column{ RunCatalog::Rows };
+    Op                 op{ Op::Eq };
+    double             value{ 0.0 };
+    std::uint64_t      seed{ 0 };        // Exact value for seed clauses.
+    bool               on_mode{ false };
+    std::string        text;
+};
+
+bool parse_catalog_query(const std::string& query, std::vector<CatalogClause>& clauses, std::string& error)
+{
+    static const std::pair<const char*, RunCatalog::Column> names[] = {
+        { "rows", RunCatalog::Rows },         { "bytes", RunCatalog::Bytes },
+        { "delta", RunCatalog::Delta },       { "duration", RunCatalog::Duration },
+        { "poweroff", RunCatalog::PowerOff }, { "idle", RunCatalog::Idle },
+        { "climb", RunCatalog::Climb },       { "cruise", RunCatalog::Cruise },
+        { "caution", RunCatalog::Caution },   { "redline", RunCatalog::RedLine },
+        { "overlimit", RunCatalog::OverLimit }, { "max_rpm", RunCatalog::MaxRpm },
+        { "verdict", RunCatalog::Verdict },   { "seed", RunCatalog::Seed },
+    };
+
+    clauses.clear();
+    std::size_t i = 0;
+    auto skip_space = [&] { while (i < query.size() && std::isspace(static_cast<unsigned char>(query[i]))) ++i; };
+    auto word = [&] {
+        std::size_t start = i;
+        while (i < query.size() && (std::isalnum(static_cast<unsigned char>(query[i])) || query[i] == '_' || query[i] == '.'
+                                    || query[i] == '-' || query[i] == '+'))
+            ++i;
+        std::string w = query.substr(start, i - start);
+        std::transform(w.begin(), w.end(), w.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return w;
+    };
+
+    skip_space();
+    if (i == query.size() || query == "all")
+        return true;
+    for (;;)
+    {
+        CatalogClause clause;
+        std::string name = word();
+        auto named = std::find_if(std::begin(names), std::end(names), [&](const auto& n) { return name == n.first; });
+        clause.on_mode = name == "mode";
+        if (named == std::end(names) && !clause.on_mode)
+        {
+            error = "unknown column '" + name + "'";
+            return false;
+        }
+        if (!clause.on_mode)
+            clause.column = named->second;
+
+        skip_space();
+        static const std::pair<const char*, CatalogClause::Op> ops[] = {
+            { "<=", CatalogClause::Op::Le }, { ">=", CatalogClause::Op::Ge }, { "!=", CatalogClause::Op::Ne },
+            { "==", CatalogClause::Op::Eq }, { "<", CatalogClause::Op::Lt },  { ">", CatalogClause::Op::Gt },
+            { "=", CatalogClause::Op::Eq },
+        };
+        auto op = std::find_if(std::begin(ops), std::end(ops),
+                               [&](const auto& o) { return query.compare(i, std::strlen(o.first), o.first) == 0; });
+        if (op == std::end(ops))
+        {
+            error = "expected a comparison after '" + name + "'";
+            return false;
+        }
+        clause.op = op->second;
+        i += std::strlen(op->first);
+        skip_space();
+
+        std::string value = word();
+        if (clause.on_mode)
+        {
+            if (clause.op != CatalogClause::Op::Eq && clause.op != CatalogClause::Op::Ne)
+            {
+                error = "mode only supports = and !=";
+                return false;
+            }
+            clause.text = value;
+        }
+        else if (clause.column == RunCatalog::Verdict && !value.empty() && std::isalpha(static_cast<unsigned char>(value[0])))
+        {
+            static const char* verdicts[] = { "successful", "maintenance", "failure" };
+            auto v = std::find_if(std::begin(verdicts), std::end(verdicts), [&](const char* s) { return value == s; });
+            if (v == std::end(verdicts))
+            {
+                error = "unknown verdict '" + value + "'";
+                return false;
+            }
+            clause.value = static_cast<double>(v - std::begin(verdicts));
+        }
+        else if (clause.column == RunCatalog::Seed)
+        {
+            // Parsed as an integer: seeds above 2^53 do not survive a double.
+            char* end = nullptr;
+            errno = 0;
+            clause.seed = std::strtoull(value.c_str(), &end, 10);
+            if (value.empty() || !std::isdigit(static_cast<unsigned char>(value[0])) || *end != '\0' || errno == ERANGE)
+            {
+                error = "expected an unsigned integer for 'seed'";
+                return false;
+            }
+        }
+        else
+        {
+            char* end = nullptr;
+            clause.value = std::strtod(value.c_str(), &end);
+            std::string unit = end ? end : "";
+            if (end == value.c_str())
+            {
+                error = "expected a number for '" + name + "'";
+                return false;
+            }
+            // "2h" or "2 h"; a following "and" is the next clause, not a unit.
+            skip_space();
+            if (unit.empty() && i < query.size() && std::isalpha(static_cast<unsigned char>(query[i])))
+            {
+                std::size_t mark = i;
+                unit = word();
+                if (unit == "and")
+                {
+                    i = mark;
+                    unit.clear();
+                }
+            }
+            static const std::pair<const char*, double> units[] = {
+                { "s", 1.0 }, { "sec", 1.0 }, { "m", 60.0 }, { "min", 60.0 },
+                { "h", 3600.0 }, { "hr", 3600.0 }, { "hours", 3600.0 }, { "d", 86400.0 },
+            };
+            bool is_time = clause.column == RunCatalog::Duration || clause.column == RunCatalog::Delta
+                        || (clause.column >= RunCatalog::PowerOff && clause.column <= RunCatalog::OverLimit);
+            if (!unit.empty())
+            {
+                auto u = std::find_if(std::begin(units), std::end(units), [&](const auto& x) { return unit == x.first; });
+                if (!is_time || u == std::end(units))
+                {
+                    error = "unit '" + unit + "' does not apply to '" + name + "'";
+                    return false;
+                }
+                clause.value *= u->second;
+            }
+        }
+        clauses.push_back(clause);
+
+        skip_space();
+        if (i == query.size())
+            return true;
+        std::string joiner = word();
+        if (joiner != "and")
+        {
+            error = "expected 'and' near '" + query.substr(i - joiner.size()) + "'";
+            return false;
+        }
+        skip_space();
+    }
+}
+
+// One pass over one column, clearing `keep` where the comparison fails.
+template <typename T>
+void narrow_catalog_mask(std::vector<std::uint8_t>& keep, const T* column, CatalogClause::Op op, T v)
+{
+    auto narrow = [&](auto test) {
+        for (std::size_t i = 0; i < keep.size(); ++i)
+            keep[i] &= static_cast<std::uint8_t>(test(column[i]));
+    };
+    switch (op)
+    {
+    case CatalogClause::Op::Lt: narrow([v](T x) { return x < v; });  break;
+    case CatalogClause::Op::Le: narrow([v](T x) { return x <= v; }); break;
+    case CatalogClause::Op::Gt: narrow([v](T x) { return x > v; });  break;
+    case CatalogClause::Op::Ge: narrow([v](T x) { return x >= v; }); break;
+    case CatalogClause::Op::Eq: narrow([v](T x) { return x == v; }); break;
+    case CatalogClause::Op::Ne: narrow([v](T x) { return x != v; }); break;
+    }
+}
+
+// Indices of matching entries, in path order. Each clause is one pass over
+// one column that narrows a byte mask, so unrelated columns are never touched.
+std::vector<std::size_t> select_catalog(const RunCatalog& catalog, const std::vector<CatalogClause>& clauses)
+{
+    const std::size_t n = catalog.size();
+    std::vector<std::uint8_t> keep(n, 1);
+    for (const CatalogClause& clause : clauses)
+    {
+        if (clause.on_mode)
+        {
+            bool want = clause.op == CatalogClause::Op::Eq;
+            for (std::size_t i = 0; i < n; ++i)
+                keep[i] &= static_cast<std::uint8_t>((catalog.mode(i) == clause.text) == want);
+            continue;
+        }
+        if (clause.column == RunCatalog::Seed)
+            narrow_catalog_mask(keep, catalog.seeds(), clause.op, clause.seed);
+        else
+            narrow_catalog_mask(keep, catalog.column(clause.column), clause.op, clause.value);
+    }
+    std::vector<std::size_t> out;
+    for (std::size_t i = 0; i < n; ++i)
+        if (keep[i])
+            out.push_back(i);
+    return out;
+}
+
+// Catalog failures never fail the run that wrote the log; they are reported.
+void catalog_log(const std::string& catalog_path, const CatalogEntry& entry)
+{
+    std::string error;
+    if (!catalog_path.empty() && !record_catalog_entry(catalog_path, entry, error))
+        std::cerr << "Catalog: " << error << "\n";
+}
+
+// Prints the paths of matching logs, one per line, so they can feed other tools.
+int run_catalog_query(const std::string& catalog_path, const std::string& query, bool long_form)
+{
+    std::vector<CatalogClause> clauses;
+    std::string error;
+    if (!parse_catalog_query(query, clauses, error))
+    {
+        std::cerr << "Catalog query: " << error << "\n";
+        return 1;
+    }
+    RunCatalog catalog;
+    if (!catalog.load(catalog_path, error))
+    {
+        std::cerr << "Catalog: " << error << "\n";
+        return 1;
+    }
+    std::vector<std::size_t> matches = select_catalog(catalog, clauses);
+    static const char* verdicts[] = { "successful", "maintenance", "failure" };
+    for (std::size_t i : matches)
+    {
+        std::cout << catalog.path(i);
+        if (long_form)
+        {
+            int verdict = static_cast<int>(catalog.value(RunCatalog::Verdict, i));
+            std::cout << '\t' << catalog.mode(i) << '\t' << catalog.value(RunCatalog::Duration, i) / 3600.0 << " h"
+                      << "\tcaution " << catalog.value(RunCatalog::Caution, i) / 3600.0 << " h"
+                      << "\tredline " << catalog.value(RunCatalog::RedLine, i) / 3600.0 << " h"
+                      << "\toverlimit " << catalog.value(RunCatalog::OverLimit, i) / 3600.0 << " h"
+                      << "\tmax " << catalog.value(RunCatalog::MaxRpm, i) << " rpm\t"
+                      << (verdict >= 0 && verdict < 3 ? verdicts[verdict] : "?");
+        }
+        std::cout << '\n';
+    }
+    std::cerr << matches.size() << " of " << catalog.size() << " runs match\n";
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Replay: re-run a recorded flight log (time_step and rpm columns) through the
+// engine model. Samples are sanitized in bulk first; rejected samples are kept
+// out of both the hour meter and the output log.
+// -----------------------------------------------------------------------------
+struct ReplayConfig
+{
+    std::string    input_path{ "flight_log.csv" };
+    std::string    output_path{ "replay_log.csv" };
+    std::string    catalog_path;     // Empty = do not catalog the output.
+    SanitizeLimits limits;
+};
+
+int run_replay_mode(const ReplayConfig& config)
+{
+    // A log with a checksum sidecar must match it; logs without one are taken as-is.
+    if (::access(checksum_sidecar_path(config.input_path).c_str(), F_OK) == 0)
+    {
+        BlockVerifyReport check;
+        std::string       error;
+        if (!verify_log_blocks(config.input_path, 1, check, error))
+        {
+            std::cerr << "Replay: " << error << "\n";
+            return 1;
+        }
+        if (!check.ok())
+        {
+            std::cerr << "Replay: " << config.input_path << " fails its checksums ("
+                      << check.bad_blocks.size() << " bad blocks"
+                      << (check.size_mismatch ? ", size mismatch" : "") << ")\n";
+            return 1;
+        }
+    }
+
+    std::ifstream in{ config.input_path };
+    if (!in)
+    {
+        std::cerr << "Failed to open " << config.input_path << "\n";
+        return 1;
+    }
+
+    // Locate the columns by name so extra or reordered columns are fine.
+    std::string line;
+    std::getline(in, line);
+    std::vector<std::string> columns;
+    for (std::size_t start = 0; start <= line.size(); )
+    {
+        std::size_t comma = line.find(',', start);
+        if (comma == std::string::npos)
+            comma = line.size();
+        columns.push_back(line.substr(start, comma - start));
+        start = comma + 1;
+    }
+    auto time_col = std::find(columns.begin(), columns.end(), "time_step") - columns.begin();
+    auto rpm_col  = std::find(columns.begin(), columns.end(), "rpm") - columns.begin();
+    if (time_col == static_cast<std::ptrdiff_t>(columns.size()) || rpm_col == static_cast<std::ptrdiff_t>(columns.size()))
+    {
+        std::cerr << config.input_path << ": expected time_step and rpm columns\n";
+        return 1;
+    }
+
+    std::vector<double> time_steps;
+    std::vector<double> rpm;
+    while (std::getline(in, line))
+    {
+        std::ptrdiff_t column = 0;
+        double t = std::numeric_limits<double>::quiet_NaN();
+        double r = std::numeric_limits<double>::quiet_NaN();
+        for (std::size_t start = 0; start <= line.size(); ++column)
+        {
+            std::size_t comma = line.find(',', start);
+            if (comma == std::string::npos)
+                comma = line.size();
+            if (column == time_col)
+                t = std::strtod(line.c_str() + start, nullptr);
+            else if (column == rpm_col)
+                r = std::strtod(line.c_str() + start, nullptr); // Accepts "nan", "inf", negatives.
+            start = comma + 1;
+        }
+        time_steps.push_back(t);
+        rpm.push_back(r);
+    }
+
+    double interval = time_steps.size() > 1 ? time_steps[1] - time_steps[0] : 60.0;
+    if (!(interval > 0.0))
+        interval = 60.0;
+
+    std::vector<double>       clean(rpm.size());
+    std::vector<std::uint8_t> flags(rpm.size());
+    SanitizeReport report = sanitize_rpm(rpm.data(), rpm.size(), interval, config.limits,
+                                         clean.data(), flags.data());
+
+    ChecksummedLogFile out{ config.output_path };
+    if (!out)
+    {
+        std::cerr << "Failed to open " << config.output_path << "\n";
+        return 1;
+    }
+
+    EnginePowerModel engine;
+    FlightHours      flight_hours;
+    CatalogRecorder  catalog;
+    engine.set_verbose(false);
+    flight_hours.csv_header(out);
+
+    constexpr double pi = 3.141592653589793;
+    for (std::size_t i = 0; i < clean.size(); ++i)
+    {
+        if (flags[i] != SampleValid)
+            continue;
+        engine.update_from_rpm((clean[i] * 2.0 * pi) / 60.0);
+        flight_hours.flight_log_hours(engine, interval);
+        flight_hours.csv_row(out, engine, time_steps[i]);
+        catalog.observe(engine.powerband(), clean[i], static_cast<double>(std::lround(interval)));
+    }
+    std::string error;
+    if (!out.close(error))
+    {
+        std::cerr << "Replay: " << error << "\n";
+        return 1;
+    }
+    catalog_log(config.catalog_path,
+                catalog.entry(config.output_path, "replay", "input=" + config.input_path, 0, interval,
+                              out.bytes_written()));
+
+    print_sanitize_report(std::cout, report);
+    Tachometer_Diagnostic diag = DiagnosticPolicy{}.evaluate(flight_hours);
+    std::cout << diag.message() << " (code " << diag.code() << ")\n";
+    std::cout << "Caution time (sec): " << flight_hours.caution_time()
+              << ", Redline/OverLimit time (sec): " << flight_hours.redline_time() << "\n";
+    std::cout << "Replay written to " << config.output_path << "\n";
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Exact summation for fleet statistics. Floating-point addition is not
+// associative, so a plain parallel sum changes in the last bits with the
+// number of threads or shards and with scheduling. ExactSum keeps the sum as
+// a fixed-point integer spanning the whole double range (32-bit digits in
+// int64 limbs, carries propagated lazily), so adding and merging are exact
+// and the rounded result is the same for any grouping or order. Plain data,
+// so it can sit in shared memory like the rest of FleetSummary.
+// -----------------------------------------------------------------------------
+class ExactSum
+{
+public:
+    void add(double x) noexcept
+    {
+        std::uint64_t u;
+        std::memcpy(&u, &x, sizeof(u));
+        int biased = static_cast<int>((u >> 52) & 0x7FF);
+        if (biased == 0x7FF)
+        {
+            special_ += x; // Inf/NaN propagate as they would in a plain sum.
+            return;
+        }
+        // x = +-magnitude * 2^(bit - 1074); subnormals have no implicit bit.
+        std::uint64_t magnitude = (u & ((std::uint64_t{ 1 } << 52) - 1)) | (biased ? std::uint64_t{ 1 } << 52 : 0);
+        std::int64_t  sign = (u >> 63) ? -1 : 1;
+        int bit = biased ? biased - 1 : 0;
+        int limb = bit / 32;
+        int shift = bit % 32;
+        std::uint64_t low  = magnitude << shift;
+        std::uint64_t high = shift ? magnitude >> (64 - shift) : 0;
+        limbs_[limb]     += sign * static_cast<std::int64_t>(low & 0xFFFFFFFFu);
+        limbs_[limb + 1] += sign * static_cast<std::int64_t>(low >> 32);
+        limbs_[limb + 2] += sign * static_cast<std::int64_t>(high);
+        if (++pending_ == k_carry_interval)
+            normalize();
+    }
+
+    void merge(const ExactSum& other) noexcept
+    {
+        for (int i = 0; i < k_limbs; ++i)
+            limbs_[i] += other.limbs_[i];
+        special_ += other.special_;
+        normalize();
+    }
+
+    // The exact sum rounded to double, always by the same sequence of operations.
+    double value() const noexcept
+    {
+        ExactSum n = *this;
+        n.normalize();
+        bool negative = n.limbs_[k_limbs - 1] < 0;
+        if (negative)
+            n.negate();
+        double result = 0.0;
+        for (int i = k_limbs - 1; i >= 0; --i)
+            if (n.limbs_[i] != 0)
+                result += std::ldexp(static_cast<double>(n.limbs_[i]), 32 * i - 1074);
+        return (negative ? -result : result) + special_;
+    }
+
+private:
+    // 2^-1074 up to the top of the double range plus carry room.
+    static constexpr int k_limbs = 70;
+    // Each add puts < 2^32 into a limb, so 2^30 adds cannot overflow int64.
+    static constexpr std::uint32_t k_carry_interval = 1u << 30;
+
+    // Leaves every limb but the top one in [0, 2^32).
+    void normalize() noexcept
+    {
+        for (int i = 0; i + 1 < k_limbs; ++i)
+        {
+            std::int64_t carry = limbs_[i] >> 32; // Arithmetic shift: floor division.
+            limbs_[i] -= carry * (std::int64_t{ 1 } << 32);
+            limbs_[i + 1] += carry;
+        }
+        pending_ = 0;
+    }
+
+    // Two's complement negation across normalized limbs.
+    void negate() noexcept
+    {
+        for (int i = 0; i < k_limbs; ++i)
+            limbs_[i] = -limbs_[i];
+        normalize();
+    }
+
+    std::int64_t  limbs_[k_limbs]{};
+    double        special_{ 0.0 };
+    std::uint32_t pending_{ 0 };
+};
+
+// Sums `count` values split into `chunks` pieces handed to `threads` workers,
+// twice: plain double partials combined in completion order, and ExactSum
+// partials. Prints time per value and the bits of each result so runs with
+// different thread counts can be compared.
+int run_reduction_benchmark(std::size_t count, std::size_t max_threads)
+{
+    using clock = std::chrono::steady_clock;
+
+    // RPM-like values with a few large and tiny outliers, where rounding order shows.
+    std::vector<double> values(count);
+    std::mt19937_64 rng(12345);
+    std::uniform_real_distribution<double> rpm(0.0, 11000.0);
+    for (std::size_t i = 0; i < count; ++i)
+        values[i] = (i % 1000 == 0) ? rpm(rng) * 1e12 * ((i / 1000) % 2 ? 1.0 : -1.0)
+                  : (i % 997 == 0)  ? rpm(rng) * 1e-9
+                                    : rpm(rng);
+
+    auto bits = [](double v) {
+        std::uint64_t u;
+        std::memcpy(&u, &v, sizeof(u));
+        char text[17];
+        std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(u));
+        return std::string(text);
+    };
+
+    std::cout << "Reduction benchmark: " << count << " values\n";
+    std::cout << "threads  plain ns/value  plain bits         exact ns/value  exact bits\n";
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2)
+    {
+        const std::size_t chunks = threads * 8;
+        const std::size_t chunk_size = (count + chunks - 1) / chunks;
+        WorkerPool pool(threads);
+
+        // Plain: per-chunk double sums folded into the total as chunks finish.
+        std::mutex total_mutex;
+        double plain = 0.0;
+        auto start = clock::now();
+        for (std::size_t c = 0; c < chunks; ++c)
+            pool.submit([&, c](std::size_t) {
+                double partial = 0.0;
+                for (std::size_t i = c * chunk_size; i < std::min(count, (c + 1) * chunk_size); ++i)
+                    partial += values[i];
+                std::lock_guard<std::mutex> lock(total_mutex);
+                plain += partial;
+            });
+        pool.wait_idle();
+        double plain_ns = std::chrono::duration<double, std::nano>(clock::now() - start).count() / count;
+
+        // Exact: per-worker accumulators merged at the end.
+        std::vector<ExactSum> partials(threads);
+        start = clock::now();
+        for (std::size_t c = 0; c < chunks; ++c)
+            pool.submit([&, c](std::size_t worker) {
+                for (std::size_t i = c * chunk_size; i < std::min(count, (c + 1) * chunk_size); ++i)
+                    partials[worker].add(values[i]);
+            });
+        pool.wait_idle();
+        ExactSum exact;
+        for (const ExactSum& p : partials)
+            exact.merge(p);
+        double exact_value = exact.value();
+        double exact_ns = std::chrono::duration<double, std::nano>(clock::now() - start).count() / count;
+
+        std::printf("%7zu  %14.3f  %s  %14.3f  %s\n", threads, plain_ns, bits(plain).c_str(), exact_ns,
+                    bits(exact_value).c_str());
+    }
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Mission heatmap: valid-sample count per (mission-time bucket, RPM bin), so a
+// review can see where in the mission high-RPM time concentrates without a
+// second pass over the logs. Cell indices are clamped, never branched on, and
+// invalid samples are added with weight zero so the tick loop stays straight.
+// -----------------------------------------------------------------------------
+class MissionHeatmap
+{
+public:
+    MissionHeatmap() = default;
+
+    // Rows cover [0, mission_seconds) in bucket_seconds steps, columns cover
+    // [0, Sensor_max_rpm] in rpm_bin steps; out-of-range values land in the
+    // first or last row/column.
+    MissionHeatmap(double mission_seconds, double bucket_seconds, double rpm_bin)
+        : bucket_seconds_(std::max(bucket_seconds, 1.0)),
+          rpm_bin_(std::max(rpm_bin, 1.0)),
+          inv_bucket_(1.0 / bucket_seconds_),
+          inv_bin_(static_cast<float>(1.0 / rpm_bin_)),
+          rows_(static_cast<std::uint32_t>(std::max(1.0, std::ceil(mission_seconds / bucket_seconds_)))),
+          cols_(static_cast<std::uint32_t>(std::floor(EnginePowerModel::Sensor_max_rpm / rpm_bin_)) + 1),
+          cells_(static_cast<std::size_t>(rows_) * cols_, 0)
+    {
+    }
+
+    std::uint32_t rows() const { return rows_; }
+    std::uint32_t cols() const { return cols_; }
+    std::size_t   size() const { return cells_.size(); }
+    std::uint64_t* data() { return cells_.data(); }
+    const std::uint64_t* data() const { return cells_.data(); }
+    std::uint64_t invalid() const { return invalid_; }
+    std::uint64_t at(std::uint32_t row, std::uint32_t col) const { return cells_[std::size_t(row) * cols_ + col]; }
+
+    std::uint32_t row_of(double seconds) const
+    {
+        double r = std::min(std::max(seconds * inv_bucket_, 0.0), static_cast<double>(rows_ - 1));
+        return static_cast<std::uint32_t>(r);
+    }
+
+    std::int32_t col_of(std::int32_t rpm) const
+    {
+        std::int32_t c = static_cast<std::int32_t>(static_cast<float>(rpm) * inv_bin_);
+        return std::min(std::max(c, 0), static_cast<std::int32_t>(cols_) - 1);
+    }
+
+    void add(double seconds, std::int32_t rpm, bool valid = true)
+    {
+        cells_[std::size_t(row_of(seconds)) * cols_ + col_of(rpm)] += valid;
+        invalid_ += !valid;
+    }
+
+    // One tick of a fleet block: every sample shares the row, so only the
+    // column is computed per engine.
+    void add_row(double seconds, const std::int32_t* rpm, const std::uint8_t* flags, std::size_t n)
+    {
+        std::uint64_t* row = cells_.data() + std::size_t(row_of(seconds)) * cols_;
+        std::uint64_t bad = 0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            std::uint64_t valid = flags[i] == SampleValid;
+            row[col_of(rpm[i])] += valid;
+            bad += 1 - valid;
+        }
+        invalid_ += bad;
+    }
+
+    bool same_shape(const MissionHeatmap& other) const
+    {
+        return rows_ == other.rows_ && cols_ == other.cols_ && bucket_seconds_ == other.bucket_seconds_
+            && rpm_bin_ == other.rpm_bin_;
+    }
+
+    // Counts are integers, so merge order never matters.
+    void merge(const std::uint64_t* cells, std::uint64_t invalid)
+    {
+        for (std::size_t i = 0; i < cells_.size(); ++i)
+            cells_[i] += cells[i];
+        invalid_ += invalid;
+    }
+    void merge(const MissionHeatmap& other)
+    {
+        if (same_shape(other))
+            merge(other.data(), other.invalid_);
+    }
+
+    std::uint64_t total() const
+    {
+        std::uint64_t sum = 0;
+        for (std::uint64_t c : cells_)
+            sum += c;
+        return sum;
+    }
+
+    // Binary PGM (P5), one pixel per cell: RPM left to right, mission time top
+    // to bottom. Log-scaled so short excursions stay visible next to cruise.
+    bool write_pgm(const std::string& path, std::string& error) const
+    {
+        std::ofstream out{ path, std::ios::binary };
+        if (!out)
+        {
+            error = "cannot open " + path;
+            return false;
+        }
+        out << "P5\n# mission heatmap: " << bucket_seconds_ << " s rows, " << rpm_bin_ << " rpm columns, log scale\n"
+            << cols_ << ' ' << rows_ << "\n255\n";
+        const std::uint64_t top = peak();
+        std::vector<unsigned char> pixels(cells_.size());
+        for (std::size_t i = 0; i < cells_.size(); ++i)
+            pixels[i] = shade(cells_[i], top);
+        out.write(reinterpret_cast<const char*>(pixels.data()), static_cast<std::streamsize>(pixels.size()));
+        if (!out.flush())
+        {
+            error = "write failed on " + path;
+            return false;
+        }
+        return true;
+    }
+
+    bool write_svg(const std::string& path, std::string& error) const
+    {
+        std::ofstream out{ path };
+        if (!out)
+        {
+            error = "cannot open " + path;
+            return false;
+        }
+        const double width = 800.0, height = 500.0, margin = 60.0;
+        const double cw = width / cols_, ch = height / rows_;
+        const std::uint64_t top = peak();
+        char buf[96];
+        out << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << width + 2 * margin << "\" height=\""
+            << height + 2 * margin << "\" font-family=\"sans-serif\" font-size=\"12\">\n"
+            << "<rect x=\"" << margin << "\" y=\"" << margin << "\" width=\"" << width << "\" height=\"" << height
+            << "\" fill=\"#fff\" stroke=\"#888\"/>\n";
+        for (std::uint32_t r = 0; r < rows_; ++r)
+            for (std::uint32_t c = 0; c < cols_; ++c)
+            {
+                std::uint64_t count = at(r, c);
+                if (count == 0)
+                    continue;
+                // White to dark red on the same log scale as the PGM.
+                int v = shade(count, top);
+                std::snprintf(buf, sizeof(buf), "#%02x%02x%02x", 255 - v / 3, 255 - v, 255 - v);
+                out << "<rect x=\"" << margin + c * cw << "\" y=\"" << margin + r * ch << "\" width=\"" << cw
+                    << "\" height=\"" << ch << "\" fill=\"" << buf << "\"><title>" << count << "</title></rect>\n";
+            }
+        std::snprintf(buf, sizeof(buf), "%.4g", cols_ * rpm_bin_);
+        out << "<text x=\"" << margin << "\" y=\"" << margin - 10 << "\">Valid samples per "
+            << rpm_bin_ << " rpm x " << bucket_seconds_ / 3600.0 << " h (log scale)</text>\n"
+            << "<text x=\"" << margin << "\" y=\"" << margin + height + 20 << "\">0 rpm</text>\n"
+            << "<text x=\"" << margin + width - 60 << "\" y=\"" << margin + height + 20 << "\">" << buf << " rpm</text>\n";
+        std::snprintf(buf, sizeof(buf), "%.4g", rows_ * bucket_seconds_ / 3600.0);
+        out << "<text x=\"4\" y=\"" << margin + 12 << "\">0 h</text>\n"
+            << "<text x=\"4\" y=\"" << margin + height << "\">" << buf << " h</text>\n</svg>\n";
+        if (!out.flush())
+        {
+            error = "write failed on " + path;
+            return false;
+        }
+        return true;
+    }
+
+    // ".svg" picks the vector form, anything else gets a PGM.
+    bool write(const std::string& path, std::string& error) const
+    {
+        bool svg = path.size() >= 4 && path.compare(path.size() - 4, 4, ".svg") == 0;
+        return svg ? write_svg(path, error) : write_pgm(path, error);
+    }
+
+private:
+    std::uint64_t peak() const
+    {
+        return cells_.empty() ? 1 : std::max<std::uint64_t>(1, *std::max_element(cells_.begin(), cells_.end()));
+    }
+
+    static unsigned char shade(std::uint64_t count, std::uint64_t peak)
+    {
+        return static_cast<unsigned char>(std::lround(255.0 * std::log1p(double(count)) / std::log1p(double(peak))));
+    }
+
+    double        bucket_seconds_{ 3600.0 };
+    double        rpm_bin_{ 250.0 };
+    double        inv_bucket_{ 1.0 / 3600.0 };
+    float         inv_bin_{ 1.0f / 250.0f };
+    std::uint32_t rows_{ 0 };
+    std::uint32_t cols_{ 0 };
+    std::vector<std::uint64_t> cells_;
+    std::uint64_t invalid_{ 0 };
+};
+
+// -----------------------------------------------------------------------------
+// Fleet: many independent engines, each with its own model, hour meter and RNG
+// -----------------------------------------------------------------------------
+struct FleetEngineRecord
+{
+    EnginePowerModel engine;
+    FlightHours      hours;
+    RPMSource        source;
+    std::uint16_t    profile{ 0 }; // Index into the fleet's BandProfileTable.
+    float            damage{ 0.0f }; // Degradation since overhaul, equivalent RedLine hours.
+    std::uint64_t    rpm_samples{ 0 };  // Raw RPM moments over valid samples, summed in
+    double           rpm_sum{ 0.0 };    // tick order, so each engine's sums are the same
+    double           rpm_sq_sum{ 0.0 }; // however the fleet is split up.
+};
+
+// Records live directly in the memory-mapped state file, so they must be
+// plain bytes: no pointers, no heap, no virtuals.
+static_assert(std::is_trivially_copyable<FleetEngineRecord>::value,
+              "FleetEngineRecord must be trivially copyable to live in a mapped file");
+
+// Per-engine seed derived from the fleet seed (splitmix64 finalizer).
+std::uint32_t fleet_engine_seed(std::uint64_t fleet_seed, std::uint64_t engine_index)
+{
+    std::uint64_t z = fleet_seed + (engine_index + 1) * 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return static_cast<std::uint32_t>(z ^ (z >> 31));
+}
+
+// Profiles a fleet is built from and the share of engines using each.
+struct FleetProfileMix
+{
+    BandProfileTable    table{ BandProfileTable::standard() };
+    std::vector<double> weights{ 1.0 }; // One per table entry.
+
+    // Deterministic in (fleet_seed, engine_index), so shards and resumes agree.
+    std::uint16_t pick(std::uint64_t fleet_seed, std::uint64_t engine_index) const
+    {
+        double total = 0.0;
+        for (double w : weights)
+            total += w;
+        double u = fleet_engine_seed(fleet_seed ^ 0x5DEECE66Dull, engine_index) / 4294967296.0 * total;
+        for (std::size_t p = 0; p + 1 < weights.size(); ++p)
+        {
+            if (u < weights[p])
+                return static_cast<std::uint16_t>(p);
+            u -= weights[p];
+        }
+        return static_cast<std::uint16_t>(weights.empty() ? 0 : weights.size() - 1);
+    }
+};
+
+// Reads profile lines "name,weight,idle_min,climb_min,cruise_min,caution_min,
+// redline_min,redline_max". Profiles with identical limits share one entry.
+bool load_profile_mix(const std::string& path, FleetProfileMix& mix, std::string& error)
+{
+    std::ifstream in{ path };
+    if (!in)
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    FleetProfileMix loaded;
+    loaded.table = BandProfileTable{};
+    loaded.weights.clear();
+
+    std::string line;
+    int line_no = 0;
+    while (std::getline(in, line))
+    {
+        ++line_no;
+        if (line.empty() || line[0] == '#' || line.compare(0, 4, "name") == 0)
+            continue;
+
+        std::vector<double> fields;
+        std::size_t comma = line.find(',');
+        for (std::size_t start = comma; start != std::string::npos; start = line.find(',', start + 1))
+            fields.push_back(std::strtod(line.c_str() + start + 1, nullptr));
+
+        BandProfile p;
+        if (fields.size() == 7)
+        {
+            p.idle_min    = static_cast<std::int32_t>(fields[1]);
+            p.climb_min   = static_cast<std::int32_t>(fields[2]);
+            p.cruise_min  = static_cast<std::int32_t>(fields[3]);
+            p.caution_min = static_cast<std::int32_t>(fields[4]);
+            p.redline_min = static_cast<std::int32_t>(fields[5]);
+            p.redline_max = static_cast<std::int32_t>(fields[6]);
+        }
+        if (fields.size() != 7 || !(fields[0] > 0.0) || !p.valid())
+        {
+            error = path + ":" + std::to_string(line_no) + ": expected name,weight and six increasing limits";
+            return false;
+        }
+
+        int index = loaded.table.add(p);
+        if (index < 0)
+        {
+            error = path + ": more than " + std::to_string(BandProfileTable::k_max_profiles) + " distinct profiles";
+            return false;
+        }
+        if (static_cast<std::size_t>(index) == loaded.weights.size())
+            loaded.weights.push_back(0.0);
+        loaded.weights[static_cast<std::size_t>(index)] += fields[0];
+    }
+
+    if (loaded.table.count == 0)
+    {
+        error = path + ": no profiles";
+        return false;
+    }
+    mix = loaded;
+    return true;
+}
+
+void init_fleet_records(FleetEngineRecord* records, std::size_t count, std::uint64_t fleet_seed,
+                        std::size_t first_engine = 0, const FleetProfileMix& mix = FleetProfileMix{})
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        FleetEngineRecord* record = new (&records[i]) FleetEngineRecord{
+            EnginePowerModel{}, FlightHours{}, RPMSource(fleet_engine_seed(fleet_seed, first_engine + i)),
+            mix.pick(fleet_seed, first_engine + i) };
+        record->engine.set_verbose(false);
+    }
+}
+
+// Advance every engine by `ticks` ticks. Engines are processed in blocks small
+// enough to keep their RNG state in cache; within a block each tick draws one
+// sample per engine and classifies the whole block against the per-engine
+// profiles with gathered thresholds. With a heatmap, each tick's samples are
+// binned at mission time (first_tick + t) * delta_seconds.
+void simulate_fleet_ticks(FleetEngineRecord* records, std::size_t count, std::uint64_t ticks,
+                          double delta_seconds, const BandProfileTable& profiles,
+                          const DegradationModel& degradation = DegradationModel{},
+                          MissionHeatmap* heatmap = nullptr, std::uint64_t first_tick = 0)
+{
+    constexpr std::size_t block = 256;
+    double          raw[block];
+    std::int32_t    rpm[block];
+    std::uint16_t   profile[block];
+    std::uint8_t    flags[block];
+    EnginePowerBand bands[block];
+    float           damage[block];
+    std::int32_t    derate[block];
+    const std::int64_t tick_seconds = std::lround(delta_seconds);
+    TickTally tally;
+
+    const bool degrade = degradation.enabled();
+    DegradationModel model = degradation;
+    model.max_derate_rpm = std::min(model.max_derate_rpm, max_safe_derate(profiles));
+
+    for (std::size_t first = 0; first < count; first += block)
+    {
+        FleetEngineRecord* r = records + first;
+        std::size_t n = std::min(block, count - first);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            profile[i] = r[i].profile < profiles.count ? r[i].profile : 0;
+            damage[i]  = r[i].damage;
+            derate[i]  = model.derate(damage[i]);
+        }
+
+        for (std::uint64_t t = 0; t < ticks; ++t)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                double value = EnginePowerModel::rpm_from_omega(r[i].source.next_omega());
+                raw[i] = value;
+                flags[i] = sanitize_rpm_value(value, EnginePowerModel::Sensor_max_rpm);
+                rpm[i] = static_cast<std::int32_t>(std::lround(value));
+            }
+            if (heatmap)
+                heatmap->add_row(static_cast<double>(first_tick + t) * delta_seconds, rpm, flags, n);
+            classify_rpm_gathered(rpm, profile, profiles, bands, n, degrade ? derate : nullptr);
+            if (degrade)
+                update_degradation(bands, flags, damage, derate, n, delta_seconds, model);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                double x = flags[i] == SampleValid ? raw[i] : 0.0;
+                r[i].rpm_samples += flags[i] == SampleValid;
+                r[i].rpm_sum     += x;
+                r[i].rpm_sq_sum  += x * x;
+                tally.add(r[i].engine.powerband(), bands[i], flags[i] == SampleValid ? tick_seconds : 0);
+                r[i].engine.load_sample(raw[i], rpm[i], bands[i], flags[i]);
+                r[i].hours.flight_log_hours(r[i].engine, delta_seconds);
+            }
+        }
+        if (degrade)
+            for (std::size_t i = 0; i < n; ++i)
+                r[i].damage = damage[i];
+        tally.flush();
+    }
+}
+
+struct FleetSummary
+{
+    std::uint64_t engines{ 0 };
+    std::uint64_t successful{ 0 };
+    std::uint64_t maintenance{ 0 };
+    std::uint64_t failure{ 0 };
+    std::int64_t  caution_seconds{ 0 };
+    std::int64_t  redline_seconds{ 0 };
+    std::uint64_t rpm_samples{ 0 };
+    // Floating-point totals are exact so that shard count and merge order
+    // cannot change a single bit of the reported statistics.
+    ExactSum      damage_hours;  // Degradation summed over engines.
+    ExactSum      rpm_sum;
+    ExactSum      rpm_sq_sum;
+
+    void merge(const FleetSummary& other)
+    {
+        engines         += other.engines;
+        successful      += other.successful;
+        maintenance     += other.maintenance;
+        failure         += other.failure;
+        caution_seconds += other.caution_seconds;
+        redline_seconds += other.redline_seconds;
+        rpm_samples     += other.rpm_samples;
+        damage_hours.merge(other.damage_hours);
+        rpm_sum.merge(other.rpm_sum);
+        rpm_sq_sum.merge(other.rpm_sq_sum);
+    }
+
+    double rpm_mean() const { return rpm_samples ? rpm_sum.value() / static_cast<double>(rpm_samples) : 0.0; }
+
+    // Sample variance from the exact moments; only the final step rounds.
+    double rpm_variance() const
+    {
+        if (rpm_samples < 2)
+            return 0.0;
+        double n = static_cast<double>(rpm_samples);
+        double sum = rpm_sum.value();
+        return std::max(0.0, (rpm_sq_sum.value() - sum * sum / n) / (n - 1.0));
+    }
+};
+
+void add_engine_summary(FleetSummary& summary, const FleetEngineRecord& record, const DiagnosticPolicy& policy)
+{
+    const FlightHours& hours = record.hours;
+    switch (policy.evaluate(hours).status())
+    {
+    case Diagnostic_Status::SystemSuccessful:          ++summary.successful;  break;
+    case Diagnostic_Status::SystemMaintenanceRequired: ++summary.maintenance; break;
+    case Diagnostic_Status::SystemCheckSystemFailure:  ++summary.failure;     break;
+    }
+    summary.caution_seconds += hours.caution_time();
+    summary.redline_seconds += hours.redline_time();
+    summary.rpm_samples     += record.rpm_samples;
+    summary.damage_hours.add(record.damage);
+    summary.rpm_sum.add(record.rpm_sum);
+    summary.rpm_sq_sum.add(record.rpm_sq_sum);
+    ++summary.engines;
+}
+
+FleetSummary summarize_fleet(const FleetEngineRecord* records, std::size_t count,
+                             const DiagnosticPolicy& policy)
+{
+    FleetSummary summary;
+    for (std::size_t i = 0; i < count; ++i)
+        add_engine_summary(summary, records[i], policy);
+    return summary;
+}
+
+void print_fleet_summary(std::ostream& os, const FleetSummary& summary)
+{
+    os << "Fleet: " << summary.engines << " engines\n"
+       << "  successful  " << summary.successful << "\n"
+       << "  maintenance " << summary.maintenance << "\n"
+       << "  failure     " << summary.failure << "\n"
+       << "  caution time (sec)           " << summary.caution_seconds << "\n"
+       << "  redline/overlimit time (sec) " << summary.redline_seconds << "\n";
+    if (summary.rpm_samples > 0)
+    {
+        char line[96];
+        std::snprintf(line, sizeof(line), "  raw rpm mean / std dev       %.17g / %.17g\n", summary.rpm_mean(),
+                      std::sqrt(summary.rpm_variance()));
+        os << line;
+    }
+    double damage = summary.damage_hours.value();
+    if (damage > 0.0 && summary.engines > 0)
+        os << "  mean damage (redline h)      " << damage / summary.engines << "\n";
+}
+
+// -----------------------------------------------------------------------------
+// Cohorts: fleet results grouped by engine type, operator, route class and
+// build year. Workers aggregate disjoint engine chunks into their own
+// open-addressing tables; the partials are merged once at the end. A cohort's
+// value is a FleetSummary, whose merge is exact, so the report does not depend
+// on the thread count.
+// -----------------------------------------------------------------------------
+enum CohortField : unsigned
+{
+    CohortType     = 1u << 0,
+    CohortOperator = 1u << 1,
+    CohortRoute    = 1u << 2,
+    CohortYear     = 1u << 3,
+    CohortAll      = CohortType | CohortOperator | CohortRoute | CohortYear
+};
+
+// Interned attribute ids. k_any marks a field that is not grouped on.
+struct CohortKey
+{
+    static constexpr std::uint32_t k_any = 0xFFFFFFFFu;
+
+    std::uint32_t type{ 0 };
+    std::uint32_t op{ 0 };
+    std::uint32_t route{ 0 };
+    std::uint32_t year{ 0 };
+
+    bool operator==(const CohortKey& other) const
+    {
+        return type == other.type && op == other.op && route == other.route && year == other.year;
+    }
+
+    std::uint64_t hash() const
+    {
+        std::uint64_t z = (std::uint64_t{ type } << 32 | op) * 0x9E3779B97F4A7C15ull
+                        ^ (std::uint64_t{ route } << 32 | year);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+};
+
+// Engine attributes from "engine,type,operator,route_class,build_year" lines,
+// where engine is an index or an inclusive range "first-last". Empty fields
+// and unlisted engines are "-"; an empty type falls back to the engine's
+// band profile.
+class CohortRegistry
+{
+public:
+    CohortRegistry() { intern("-"); }
+
+    bool load(const std::string& path, std::string& error)
+    {
+        std::ifstream in{ path };
+        if (!in)
+        {
+            error = "cannot open " + path;
+            return false;
+        }
+        std::string line;
+        for (int number = 1; std::getline(in, line); ++number)
+        {
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back(); // Registries exported with CRLF line ends.
+            if (line.empty() || line[0] == '#' || line.compare(0, 6, "engine") == 0)
+                continue;
+            std::vector<std::string> fields;
+            for (std::size_t start = 0;;)
+            {
+                std::size_t comma = line.find(',', start);
+                fields.push_back(line.substr(start, comma - start));
+                if (comma == std::string::npos)
+                    break;
+                start = comma + 1;
+            }
+            Range range;
+            char* end = nullptr;
+            range.first = std::strtoull(fields[0].c_str(), &end, 10);
+            range.last = *end == '-' ? std::strtoull(end + 1, &end, 10) : range.first;
+            if (fields.size() != 5 || end == fields[0].c_str() || *end != '\0' || range.last < range.first)
+            {
+                error = path + ":" + std::to_string(number) + ": expected engine,type,operator,route_class,build_year";
+                return false;
+            }
+            range.key.type  = fields[1].empty() ? CohortKey::k_any : intern(fields[1]);
+            range.key.op    = intern(fields[2].empty() ? "-" : fields[2]);
+            range.key.route = intern(fields[3].empty() ? "-" : fields[3]);
+            range.key.year  = intern(fields[4].empty() ? "-" : fields[4]);
+            ranges_.push_back(range);
+        }
+        // Where ranges overlap, the one starting last wins (ties: the later line).
+        std::stable_sort(ranges_.begin(), ranges_.end(),
+                         [](const Range& a, const Range& b) { return a.first < b.first; });
+        flatten();
+        return true;
+    }
+
+    // Called before aggregation starts; lookups are read-only afterwards.
+    void name_profiles(std::size_t count)
+    {
+        profile_ids_.clear();
+        for (std::size_t p = 0; p < count; ++p)
+            profile_ids_.push_back(intern("profile" + std::to_string(p)));
+    }
+
+    CohortKey lookup(std::uint64_t engine, std::uint16_t profile, unsigned fields) const
+    {
+        CohortKey key;
+        key.type = key.op = key.route = key.year = 0; // "-"
+        auto it = std::upper_bound(ranges_.begin(), ranges_.end(), engine,
+                                   [](std::uint64_t e, const Range& r) { return e < r.first; });
+        if (it != ranges_.begin() && engine <= std::prev(it)->last)
+            key = std::prev(it)->key;
+        if (key.type == CohortKey::k_any || key.type == 0)
+            key.type = profile < profile_ids_.size() ? profile_ids_[profile] : 0;
+        if (!(fields & CohortType))     key.type  = CohortKey::k_any;
+        if (!(fields & CohortOperator)) key.op    = CohortKey::k_any;
+        if (!(fields & CohortRoute))    key.route = CohortKey::k_any;
+        if (!(fields & CohortYear))     key.year  = CohortKey::k_any;
+        return key;
+    }
+
+    const std::string& name(std::uint32_t id) const
+    {
+        static const std::string any = "*";
+        return id == CohortKey::k_any ? any : names_[id];
+    }
+
+private:
+    struct Range
+    {
+        std::uint64_t first{ 0 };
+        std::uint64_t last{ 0 };
+        CohortKey     key;
+    };
+
+    // Rewrites the sorted, possibly overlapping ranges as disjoint ones holding
+    // each engine's winning key, so a lookup is a single binary search. A sweep
+    // keeps the ranges started so far in a heap by precedence (their index) and
+    // drops the ones that ended once they surface.
+    void flatten()
+    {
+        std::vector<Range> flat;
+        std::vector<std::size_t> active;
+        std::uint64_t at = 0; // First engine not yet assigned.
+        bool done = false;    // Assigned through UINT64_MAX.
+        auto emit = [&](const Range& winner, std::uint64_t last) {
+            if (!flat.empty() && flat.back().key == winner.key && flat.back().last + 1 == at)
+                flat.back().last = last;
+            else
+                flat.push_back(Range{ at, last, winner.key });
+            done = last == std::numeric_limits<std::uint64_t>::max();
+            at = last + 1;
+        };
+        // Assigns engines [at, limit) (everything, when unbounded) to the active winners.
+        auto sweep = [&](std::uint64_t limit, bool unbounded) {
+            while (!done && (unbounded || at < limit) && !active.empty())
+            {
+                const Range& top = ranges_[active.front()];
+                if (top.last < at)
+                {
+                    std::pop_heap(active.begin(), active.end());
+                    active.pop_back();
+                    continue;
+                }
+                emit(top, unbounded ? top.last : std::min(top.last, limit - 1));
+            }
+        };
+        for (std::size_t i = 0; i < ranges_.size(); ++i)
+        {
+            sweep(ranges_[i].first, false);
+            if (!done)
+                at = std::max(at, ranges_[i].first);
+            active.push_back(i);
+            std::push_heap(active.begin(), active.end());
+        }
+        sweep(0, true);
+        ranges_.swap(flat);
+    }
+
+    std::uint32_t intern(const std::string& text)
+    {
+        auto it = ids_.emplace(text, static_cast<std::uint32_t>(names_.size()));
+        if (it.second)
+            names_.push_back(text);
+        return it.first->second;
+    }
+
+    std::vector<Range>                              ranges_;
+    std::vector<std::string>                        names_;
+    std::unordered_map<std::string, std::uint32_t> ids_;
+    std::vector<std::uint32_t>                      profile_ids_;
+};
+
+// Linear probing over a power-of-two slot array of (key, value index). Values
+// live in insertion order in a separate vector so growing only rehashes the
+// small slots, never the summaries.
+class CohortTable
+{
+public:
+    CohortTable() : slots_(16) {}
+
+    FleetSummary& at(const CohortKey& key)
+    {
+        std::size_t mask = slots_.size() - 1;
+        for (std::size_t i = key.hash() & mask;; i = (i + 1) & mask)
+        {
+            Slot& slot = slots_[i];
+            if (slot.value == 0)
+            {
+                keys_.push_back(key);
+                values_.emplace_back();
+                slot.key = key;
+                slot.value = static_cast<std::uint32_t>(values_.size());
+                if (values_.size() * 2 > slots_.size())
+                {
+                    grow();
+                    return values_.back();
+                }
+                return values_[slot.value - 1];
+            }
+            if (slot.key == key)
+                return values_[slot.value - 1];
+        }
+    }
+
+    void merge(const CohortTable& other)
+    {
+        for (std::size_t i = 0; i < other.keys_.size(); ++i)
+            at(other.keys_[i]).merge(other.values_[i]);
+    }
+
+    std::size_t size() const { return keys_.size(); }
+    const CohortKey& key(std::size_t i) const { return keys_[i]; }
+    const FleetSummary& value(std::size_t i) const { return values_[i]; }
+
+private:
+    struct Slot
+    {
+        CohortKey     key;
+        std::uint32_t value{ 0 }; // 1-based index into values_, 0 = empty.
+    };
+
+    void grow()
+    {
+        std::vector<Slot> old(slots_.size() * 2);
+        old.swap(slots_);
+        std::size_t mask = slots_.size() - 1;
+        for (const Slot& slot : old)
+        {
+            if (slot.value == 0)
+                continue;
+            std::size_t i = slot.key.hash() & mask;
+            while (slots_[i].value != 0)
+                i = (i + 1) & mask;
+            slots_[i] = slot;
+        }
+    }
+
+    std::vector<Slot>         slots_;
+    std::vector<CohortKey>    keys_;
+    std::vector<FleetSummary> values_;
+};
+
+// "type,operator,route,year" in any order and subset.
+bool parse_cohort_fields(const std::string& text, unsigned& fields)
+{
+    unsigned parsed = 0;
+    std::stringstream in{ text };
+    std::string name;
+    while (std::getline(in, name, ','))
+    {
+        if (name == "type")          parsed |= CohortType;
+        else if (name == "operator") parsed |= CohortOperator;
+        else if (name == "route")    parsed |= CohortRoute;
+        else if (name == "year")     parsed |= CohortYear;
+        else return false;
+    }
+    if (parsed == 0)
+        return false;
+    fields = parsed;
+    return true;
+}
+
+CohortTable aggregate_cohorts(const FleetEngineRecord* records, std::size_t count, std::uint64_t first_engine,
+                              const CohortRegistry& registry, unsigned fields, const DiagnosticPolicy& policy,
+                              std::size_t threads)
+{
+    threads = std::max<std::size_t>(1, std::min<std::size_t>(threads, (count + 4095) / 4096));
+    std::vector<CohortTable> partials(threads);
+    {
+        constexpr std::size_t chunk = 4096;
+        WorkerPool pool(threads);
+        for (std::size_t begin = 0; begin < count; begin += chunk)
+            pool.submit([&, begin](std::size_t worker) {
+                CohortTable& table = partials[worker];
+                for (std::size_t i = begin; i < std::min(count, begin + chunk); ++i)
+                {
+                    CohortKey key = registry.lookup(first_engine + i, records[i].profile, fields);
+                    add_engine_summary(table.at(key), records[i], policy);
+                }
+            });
+        pool.wait_idle();
+    }
+    for (std::size_t w = 1; w < partials.size(); ++w)
+        partials[0].merge(partials[w]);
+    return std::move(partials[0]);
+}
+
+// One row per cohort, sorted by name. Rates are shares of the cohort's
+// engines; hours, RPM and damage are per-engine means.
+void write_cohort_report(std::ostream& os, const CohortTable& table, const CohortRegistry& registry, bool csv)
+{
+    std::vector<std::size_t> order(table.size());
+    for (std::size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    auto names = [&](std::size_t i) {
+        const CohortKey& k = table.key(i);
+        return std::make_tuple(registry.name(k.type), registry.name(k.op), registry.name(k.route), registry.name(k.year));
+    };
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return names(a) < names(b); });
+
+    char line[256];
+    if (csv)
+        os << "type,operator,route,year,engines,successful,maintenance,failure,"
+              "successful_rate,maintenance_rate,failure_rate,mean_caution_h,mean_redline_h,rpm_mean,mean_damage_h\n";
+    else
+    {
+        std::snprintf(line, sizeof(line), "%-12s %-12s %-8s %-6s %8s %7s %7s %7s %9s %9s %8s %8s\n", "type",
+                      "operator", "route", "year", "engines", "ok%", "maint%", "fail%", "caution h", "redline h",
+                      "rpm", "damage h");
+        os << line;
+    }
+    for (std::size_t i : order)
+    {
+        const CohortKey& k = table.key(i);
+        const FleetSummary& s = table.value(i);
+        double n = static_cast<double>(std::max<std::uint64_t>(s.engines, 1));
+        double rpm = s.rpm_samples ? s.rpm_mean() : 0.0;
+        if (csv)
+            std::snprintf(line, sizeof(line), "%s,%s,%s,%s,%llu,%llu,%llu,%llu,%.6f,%.6f,%.6f,%.4f,%.4f,%.2f,%.4f\n",
+                          registry.name(k.type).c_str(), registry.name(k.op).c_str(), registry.name(k.route).c_str(),
+                          registry.name(k.year).c_str(), static_cast<unsigned long long>(s.engines),
+                          static_cast<unsigned long long>(s.successful), static_cast<unsigned long long>(s.maintenance),
+                          static_cast<unsigned long long>(s.failure), s.successful / n, s.maintenance / n,
+                          s.failure / n, s.caution_seconds / 3600.0 / n, s.redline_seconds / 3600.0 / n, rpm,
+                          s.damage_hours.value() / n);
+        else
+            std::snprintf(line, sizeof(line), "%-12s %-12s %-8s %-6s %8llu %7.1f %7.1f %7.1f %9.2f %9.2f %8.0f %8.2f\n",
+                          registry.name(k.type).c_str(), registry.name(k.op).c_str(), registry.name(k.route).c_str(),
+                          registry.name(k.year).c_str(), static_cast<unsigned long long>(s.engines),
+                          100.0 * s.successful / n, 100.0 * s.maintenance / n, 100.0 * s.failure / n,
+                          s.caution_seconds / 3600.0 / n, s.redline_seconds / 3600.0 / n, rpm,
+                          s.damage_hours.value() / n);
+        os << line;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Persistent fleet state: memory-mapped file with two record slots.
+//
+// Layout (page aligned):  [header page][slot 0 records][slot 1 records]
+//
+// The committed slot is never written. A batch copies it into the other slot,
+// simulates there in place, msyncs the slot, and only then publishes a commit
+// marker naming it. Markers alternate between two header entries so a torn
+// marker write leaves the previous one intact. A crash loses at most the batch
+// in flight, and reopening is just mmap + pick the newest valid marker. Each
+// marker also carries the CRC32C of the slot it names, so a slot damaged on
+// disk is caught on open and the older commit is used if it is still intact.
+// -----------------------------------------------------------------------------
+struct FleetCommitMarker
+{
+    std::uint64_t sequence{ 0 };   // 0 = never written.
+    std::uint64_t ticks_done{ 0 };
+    std::uint32_t slot{ 0 };
+    std::uint32_t slot_crc{ 0 };   // CRC32C of the named slot's records.
+    std::uint64_t check{ 0 };      // Detects torn marker writes.
+};
+
+struct FleetStateHeader
+{
+    char              magic[8];
+    std::uint32_t     version;
+    std::uint32_t     record_size;
+    std::uint64_t     engine_count;
+    std::uint64_t     fleet_seed;
+    double            delta_seconds;
+    std::uint64_t     slot_offset[2];
+    FleetCommitMarker markers[2];
+    BandProfileTable  profiles;      // Records refer to these by index.
+    DegradationModel  degradation;   // Fixed for the life of the file, like delta_seconds.
+};
+
+class FleetStateFile
+{
+public:
+    static constexpr std::uint32_t k_version = 8; // 2: per-engine band profiles, 3: degradation, 4: RPM moments, 5: slot CRCs,
+                                                  // 6: RPMSource stream options, 7: per-band hour totals,
+                                                  // 8: 64-bit totals derived from the bands.
+
+    FleetStateFile() = default;
+    FleetStateFile(const FleetStateFile&) = delete;
+    FleetStateFile& operator=(const FleetStateFile&) = delete;
+    ~FleetStateFile() { close(); }
+
+    // Maps an existing state file, or creates and seeds a new one.
+    // Returns false with a message in `error` on any mismatch or I/O failure.
+    bool open(const std::string& path, std::uint64_t engine_count, std::uint64_t fleet_seed,
+              double delta_seconds, const FleetProfileMix& mix, const DegradationModel& degradation,
+              std::string& error)
+    {
+        close();
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd_ < 0)
+        {
+            error = "cannot open " + path + ": " + std::strerror(errno);
+            return false;
+        }
+
+        struct stat st{};
+        if (::fstat(fd_, &st) != 0)
+        {
+            error = "cannot stat " + path + ": " + std::strerror(errno);
+            return false;
+        }
+        bool fresh = st.st_size == 0;
+
+        const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        if (sizeof(FleetStateHeader) > page)
+        {
+            error = "fleet state header does not fit in one page";
+            return false;
+        }
+        std::size_t slot_bytes = round_up(engine_count * sizeof(FleetEngineRecord), page);
+        std::size_t file_bytes = page + 2 * slot_bytes;
+
+        if (fresh)
+        {
+            if (::ftruncate(fd_, static_cast<off_t>(file_bytes)) != 0)
+            {
+                error = "cannot size " + path + ": " + std::strerror(errno);
+                return false;
+            }
+        }
+        else if (static_cast<std::size_t>(st.st_size) != file_bytes)
+        {
+            error = path + " was written for a different fleet size or layout";
+            return false;
+        }
+
+        if (!map(file_bytes, error))
+            return false;
+
+        // A crash between sizing the file and the first publish leaves a
+        // header that was never committed; start that file over.
+        if (!fresh && never_committed())
+            fresh = true;
+
+        if (fresh)
+        {
+            FleetStateHeader* h = header();
+            std::memcpy(h->magic, k_magic, sizeof(h->magic));
+            h->version        = k_version;
+            h->record_size    = sizeof(FleetEngineRecord);
+            h->engine_count   = engine_count;
+            h->fleet_seed     = fleet_seed;
+            h->delta_seconds  = delta_seconds;
+            h->slot_offset[0] = page;
+            h->slot_offset[1] = page + slot_bytes;
+            h->markers[0]     = FleetCommitMarker{};
+            h->markers[1]     = FleetCommitMarker{};
+            h->profiles       = mix.table;
+            h->degradation    = degradation;
+
+            init_fleet_records(slot(0), engine_count, fleet_seed, 0, mix);
+            if (!sync(slot(0), slot_bytes, error))
+                return false;
+            return publish(0, 0, error);
+        }
+
+        const FleetStateHeader* h = header();
+        if (std::memcmp(h->magic, k_magic, sizeof(h->magic)) != 0)
+        {
+            error = path + " is not a fleet state file";
+            return false;
+        }
+        if (h->version != k_version || h->record_size != sizeof(FleetEngineRecord))
+        {
+            error = path + " has layout version " + std::to_string(h->version)
+                  + ", this build expects " + std::to_string(k_version);
+            return false;
+        }
+        if (h->engine_count != engine_count)
+        {
+            error = path + " holds " + std::to_string(h->engine_count) + " engines";
+            return false;
+        }
+        if (h->fleet_seed != fleet_seed)
+        {
+            error = path + " was started with --seed " + std::to_string(h->fleet_seed);
+            return false;
+        }
+        if (h->delta_seconds != delta_seconds)
+        {
+            error = path + " was started with --delta " + std::to_string(h->delta_seconds);
+            return false;
+        }
+        if (!latest_marker(committed_))
+        {
+            error = path + " has no commit marker with an intact slot";
+            return false;
+        }
+        return true;
+    }
+
+    static bool is_image(const char* data, std::size_t size)
+    {
+        return size >= sizeof(k_magic) && std::memcmp(data, k_magic, sizeof(k_magic)) == 0;
+    }
+
+    // Checks a state file image (e.g. a read-only mapping) without opening it
+    // for writing: header, markers, and the CRC of the newest intact commit.
+    // Returns false with the reason in `error`; on success `note` describes
+    // the commit that would be resumed.
+    static bool verify_image(const char* data, std::size_t size, std::string& note, std::string& error)
+    {
+        if (size < sizeof(FleetStateHeader) || !is_image(data, size))
+        {
+            error = "not a fleet state file";
+            return false;
+        }
+        FleetStateHeader h;
+        std::memcpy(&h, data, sizeof(h));
+        if (h.version != k_version || h.record_size != sizeof(FleetEngineRecord))
+        {
+            error = "layout version " + std::to_string(h.version) + ", this build expects "
+                  + std::to_string(k_version);
+            return false;
+        }
+        std::size_t slot_bytes = h.engine_count * sizeof(FleetEngineRecord);
+        for (std::uint64_t offset : h.slot_offset)
+        {
+            if (offset > size || size - offset < slot_bytes)
+            {
+                error = "truncated";
+                return false;
+            }
+        }
+        FleetCommitMarker m;
+        bool found = false;
+        for (int attempt = 0; attempt < 2 && !found; ++attempt)
+        {
+            if (!newest_marker(h, m, attempt == 1 ? m.sequence : 0))
+                break;
+            found = crc32c(0, data + h.slot_offset[m.slot], slot_bytes) == m.slot_crc;
+            if (found && attempt == 1)
+                note = "newest commit is damaged; ";
+        }
+        if (!found)
+        {
+            error = "no commit marker with an intact slot";
+            return false;
+        }
+        note += "commit " + std::to_string(m.sequence) + " at tick " + std::to_string(m.ticks_done) + ", "
+              + std::to_string(h.engine_count) + " engines";
+        return true;
+    }
+
+    void close()
+    {
+        if (base_)
+            ::munmap(base_, mapped_bytes_);
+        if (fd_ >= 0)
+            ::close(fd_);
+        base_ = nullptr;
+        fd_ = -1;
+    }
+
+    std::uint64_t engine_count() const       { return header()->engine_count; }
+    std::uint64_t fleet_seed() const         { return header()->fleet_seed; }
+    double        delta_seconds() const      { return header()->delta_seconds; }
+    const BandProfileTable& profiles() const { return header()->profiles; }
+    const DegradationModel& degradation() const { return header()->degradation; }
+    std::uint64_t ticks_done() const         { return committed_.ticks_done; }
+    std::uint64_t sequence() const           { return committed_.sequence; }
+
+    const FleetEngineRecord* committed() const { return slot(committed_.slot); }
+
+    // Copies the committed records into the spare slot and returns it for in-place updates.
+    FleetEngineRecord* begin_batch()
+    {
+        std::uint32_t spare = committed_.slot ^ 1u;
+        std::memcpy(static_cast<void*>(slot(spare)), committed(),
+                    engine_count() * sizeof(FleetEngineRecord));
+        return slot(spare);
+    }
+
+    // Makes the spare slot durable, then publishes it as the committed state.
+    bool commit_batch(std::uint64_t ticks_done, std::string& error)
+    {
+        std::uint32_t spare = committed_.slot ^ 1u;
+        if (!sync(slot(spare), engine_count() * sizeof(FleetEngineRecord), error))
+            return false;
+        return publish(spare, ticks_done, error);
+    }
+
+private:
+    static constexpr char k_magic[8] = { 'T', 'A', 'C', 'H', 'F', 'L', 'T', '\0' };
+
+    static std::size_t round_up(std::size_t n, std::size_t page)
+    {
+        return ((n + page - 1) / page) * page;
+    }
+
+    // Header zeroed or written, but neither marker ever published.
+    bool never_committed() const
+    {
+        static const char zero[sizeof(k_magic)] = {};
+        const FleetStateHeader* h = header();
+        bool magic = std::memcmp(h->magic, k_magic, sizeof(k_magic)) == 0
+                  || std::memcmp(h->magic, zero, sizeof(zero)) == 0;
+        return magic && h->markers[0].sequence == 0 && h->markers[1].sequence == 0;
+    }
+
+    static std::uint64_t marker_check(const FleetCommitMarker& m)
+    {
+        return (m.sequence * 0x9E3779B97F4A7C15ull) ^ (m.ticks_done * 0xC2B2AE3D27D4EB4Full)
+             ^ (static_cast<std::uint64_t>(m.slot) + 0x165667B19E3779F9ull)
+             ^ (static_cast<std::uint64_t>(m.slot_crc) << 29);
+    }
+
+    // Newest well-formed marker, or the newest one older than `below` when non-zero.
+    static bool newest_marker(const FleetStateHeader& h, FleetCommitMarker& out, std::uint64_t below)
+    {
+        bool found = false;
+        for (const FleetCommitMarker& m : h.markers)
+        {
+            if (m.sequence == 0 || m.slot > 1 || m.check != marker_check(m))
+                continue;
+            if (below != 0 && m.sequence >= below)
+                continue;
+            if (!found || m.sequence > out.sequence)
+            {
+                out = m;
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    std::uint32_t slot_crc(std::uint32_t index) const
+    {
+        return crc32c(0, slot(index), engine_count() * sizeof(FleetEngineRecord));
+    }
+
+    FleetStateHeader* header() const { return static_cast<FleetStateHeader*>(base_); }
+
+    FleetEngineRecord* slot(std::uint32_t index) const
+    {
+        return reinterpret_cast<FleetEngineRecord*>(
+            static_cast<char*>(base_) + header()->slot_offset[index]);
+    }
+
+    bool map(std::size_t bytes, std::string& error)
+    {
+        void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED)
+        {
+            error = std::string("mmap failed: ") + std::strerror(errno);
+            return false;
+        }
+        base_ = p;
+        mapped_bytes_ = bytes;
+        return true;
+    }
+
+    bool sync(const void* addr, std::size_t bytes, std::string& error)
+    {
+        // msync needs a page-aligned start address.
+        const std::uintptr_t page = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+        std::uintptr_t start = reinterpret_cast<std::uintptr_t>(addr) & ~(page - 1);
+        std::uintptr_t end = reinterpret_cast<std::uintptr_t>(addr) + bytes;
+        if (::msync(reinterpret_cast<void*>(start), end - start, MS_SYNC) != 0)
+        {
+            error = std::string("msync failed: ") + std::strerror(errno);
+            return false;
+        }
+        return true;
+    }
+
+    // Newest marker whose slot still matches its CRC. The older marker only
+    // qualifies if no batch has started overwriting its slot since.
+    bool latest_marker(FleetCommitMarker& out) const
+    {
+        if (!newest_marker(*header(), out, 0))
+            return false;
+        if (slot_crc(out.slot) == out.slot_crc)
+            return true;
+        return newest_marker(*header(), out, out.sequence) && slot_crc(out.slot) == out.slot_crc;
+    }
+
+    bool publish(std::uint32_t slot_index, std::uint64_t ticks_done, std::string& error)
+    {
+        FleetCommitMarker m;
+        m.sequence   = committed_.sequence + 1;
+        m.ticks_done = ticks_done;
+        m.slot       = slot_index;
+        m.slot_crc   = slot_crc(slot_index);
+        m.check      = marker_check(m);
+
+        // Overwrite the older of the two marker entries.
+        header()->markers[m.sequence % 2] = m;
+        if (!sync(header(), sizeof(FleetStateHeader), error))
+            return false;
+        committed_ = m;
+        return true;
+    }
+
+    int         fd_{ -1 };
+    void*       base_{ nullptr };
+    std::size_t mapped_bytes_{ 0 };
+    FleetCommitMarker committed_{};
+};
+
+struct FleetConfig
+{
+    std::uint64_t engines{ 100 };
+    std::uint64_t ticks{ 50 * 60 };  // Per engine; 50 hours at 1-minute ticks.
+    std::uint64_t batch{ 60 };       // Ticks per durable commit.
+    std::uint64_t seed{ 1 };
+    double        delta_seconds{ 60.0 };
+    std::string   state_path;        // Empty = in-memory run.
+    FleetProfileMix profiles;        // Ignored on resume: the state file keeps its own table.
+    DegradationModel degradation;    // Likewise fixed by the state file on resume.
+    std::string   heatmap_path;      // Empty = no mission heatmap.
+    double        heatmap_bucket_hours{ 1.0 };
+    double        heatmap_rpm_bin{ 250.0 };
+    unsigned      cohort_fields{ 0 };   // CohortField bits; 0 = no cohort report.
+    std::string   registry_path;        // Engine attributes for the cohort report.
+    std::string   cohort_csv_path;      // Also write the report as CSV.
+    std::size_t   threads{ 0 };         // Cohort aggregation; 0 = one per core.
+
+    MissionHeatmap make_heatmap() const
+    {
+        return MissionHeatmap(static_cast<double>(ticks) * delta_seconds, heatmap_bucket_hours * 3600.0,
+                              heatmap_rpm_bin);
+    }
+};
+
+int write_fleet_heatmap(const MissionHeatmap& heatmap, const std::string& path)
+{
+    std::string error;
+    if (!heatmap.write(path, error))
+    {
+        std::cerr << "Heatmap: " << error << "\n";
+        return 1;
+    }
+    std::cout << "Heatmap: " << heatmap.rows() << " x " << heatmap.cols() << " cells, " << heatmap.total()
+              << " valid samples (" << heatmap.invalid() << " rejected) -> " << path << "\n";
+    return 0;
+}
+
+int report_fleet_cohorts(const FleetConfig& config, const FleetEngineRecord* records, std::size_t count,
+                         std::size_t profile_count, const DiagnosticPolicy& policy)
+{
+    CohortRegistry registry;
+    std::string error;
+    if (!config.registry_path.empty() && !registry.load(config.registry_path, error))
+    {
+        std::cerr << "Registry: " << error << "\n";
+        return 1;
+    }
+    registry.name_profiles(profile_count);
+    std::size_t threads = config.threads ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+    CohortTable table = aggregate_cohorts(records, count, 0, registry, config.cohort_fields, policy, threads);
+
+    std::cout << "Cohorts: " << table.size() << "\n";
+    write_cohort_report(std::cout, table, registry, false);
+    if (!config.cohort_csv_path.empty())
+    {
+        ChecksummedLogFile csv{ config.cohort_csv_path };
+        if (!csv)
+        {
+            std::cerr << "Cohorts: cannot write " << config.cohort_csv_path << "\n";
+            return 1;
+        }
+        write_cohort_report(csv, table, registry, true);
+        if (!csv.close(error))
+        {
+            std::cerr << "Cohorts: " << error << "\n";
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int run_fleet_mode(const FleetConfig& config)
+{
+    DiagnosticPolicy policy;
+
+    if (config.state_path.empty())
+    {
+        std::vector<FleetEngineRecord> records(config.engines);
+        MissionHeatmap heatmap = config.make_heatmap();
+        MissionHeatmap* map = config.heatmap_path.empty() ? nullptr : &heatmap;
+        init_fleet_records(records.data(), records.size(), config.seed, 0, config.profiles);
+        simulate_fleet_ticks(records.data(), records.size(), config.ticks, config.delta_seconds,
+                             config.profiles.table, config.degradation, map);
+        print_fleet_summary(std::cout, summarize_fleet(records.data(), records.size(), policy));
+        if (config.cohort_fields
+            && report_fleet_cohorts(config, records.data(), records.size(), config.profiles.table.count, policy) != 0)
+            return 1;
+        return map ? write_fleet_heatmap(heatmap, config.heatmap_path) : 0;
+    }
+
+    FleetStateFile state;
+    std::string error;
+    if (!state.open(config.state_path, config.engines, config.seed, config.delta_seconds,
+                    config.profiles, config.degradation, error))
+    {
+        std::cerr << "Fleet state: " << error << "\n";
+        return 1;
+    }
+    if (state.ticks_done() > 0)
+        std::cout << "Resuming " << config.state_path << " at tick " << state.ticks_done()
+                  << " (commit " << state.sequence() << ")\n";
+
+    // The heatmap is not part of the state file: after a resume it covers the
+    // ticks simulated by this invocation only.
+    FleetConfig shape = config;
+    shape.delta_seconds = state.delta_seconds();
+    MissionHeatmap heatmap = shape.make_heatmap();
+    MissionHeatmap* map = config.heatmap_path.empty() ? nullptr : &heatmap;
+    if (map && state.ticks_done() > 0)
+        std::cout << "Heatmap starts at tick " << state.ticks_done() << "\n";
+
+    std::uint64_t batch = std::max<std::uint64_t>(config.batch, 1);
+    while (state.ticks_done() < config.ticks)
+    {
+        std::uint64_t step = std::min(batch, config.ticks - state.ticks_done());
+        FleetEngineRecord* records = state.begin_batch();
+        simulate_fleet_ticks(records, state.engine_count(), step, state.delta_seconds(), state.profiles(),
+                             state.degradation(), map, state.ticks_done());
+        if (!state.commit_batch(state.ticks_done() + step, error))
+        {
+            std::cerr << "Fleet state: " << error << "\n";
+            return 1;
+        }
+    }
+
+    print_fleet_summary(std::cout, summarize_fleet(state.committed(), state.engine_count(), policy));
+    if (config.cohort_fields
+        && report_fleet_cohorts(config, state.committed(), state.engine_count(), state.profiles().count, policy) != 0)
+        return 1;
+    return map ? write_fleet_heatmap(heatmap, config.heatmap_path) : 0;
+}
+
+// -----------------------------------------------------------------------------
+// Verify: checks logs against their CRC sidecars, fleet state files against
+// their commit markers and run catalogs against their trailer, without writing
+// anything.
+// -----------------------------------------------------------------------------
+int run_verify_mode(const std::vector<std::string>& paths, std::size_t threads)
+{
+    using clock = std::chrono::steady_clock;
+    int failures = 0;
+    for (const std::string& path : paths)
+    {
+        const auto start = clock::now();
+        std::string error;
+        std::string note;
+        std::uint64_t bytes = 0;
+        bool ok = false;
+
+        MappedInput file;
+        if (file.open(path, error) && FleetStateFile::is_image(file.data(), file.size()))
+        {
+            bytes = file.size();
+            ok = FleetStateFile::verify_image(file.data(), file.size(), note, error);
+        }
+        else if (error.empty() && RunCatalog::is_image(file.data(), file.size()))
+        {
+            bytes = file.size();
+            ok = RunCatalog::verify_image(file.data(), file.size(), note, error);
+        }
+        else if (error.empty())
+        {
+            BlockVerifyReport report;
+            if (verify_log_blocks(path, threads, report, error))
+            {
+                bytes = report.bytes;
+                ok = report.ok();
+                note = std::to_string(report.blocks) + " blocks";
+                if (report.size_mismatch)
+                    error = "size does not match its sidecar";
+                else if (!ok)
+                {
+                    error = std::to_string(report.bad_blocks.size()) + " bad blocks, first at byte "
+                          + std::to_string(report.bad_blocks.front() * report.block_bytes);
+                }
+            }
+        }
+
+        double elapsed = std::chrono::duration<double>(clock::now() - start).count();
+        if (ok)
+        {
+            std::cout << path << ": OK (" << note << ", " << bytes << " bytes, "
+                      << (elapsed > 0.0 ? bytes / elapsed / 1e9 : 0.0) << " GB/s)\n";
+        }
+        else
+        {
+            std::cout << path << ": FAILED (" << error << ")\n";
+            ++failures;
+        }
+    }
+    return failures == 0 ? 0 : 2;
+}
+
+// -----------------------------------------------------------------------------
+// C ABI (tachsim.h): embeddable entry points for libtachsim. No printing,
+// caller-owned buffers, status codes instead of exceptions.
+// -----------------------------------------------------------------------------
+struct tachsim_simulator
+{
+    EnginePowerModel engine;
+    FlightHours      hours;
+    RPMSource        source;
+    DiagnosticPolicy policy;
+    std::uint64_t    ticks{ 0 };
+
+    explicit tachsim_simulator(std::uint64_t seed)
+        : source(fleet_engine_seed(seed, 0))
+    {
+        engine.set_verbose(false);
+    }
+
+    void apply(double omega, double delta_seconds, std::int32_t* rpm_out, std::uint16_t* band_out, std::size_t i)
+    {
+        engine.update_from_rpm(omega);
+        hours.flight_log_hours(engine, delta_seconds);
+        ++ticks;
+        if (rpm_out)
+            rpm_out[i] = engine.filtered_rpm();
+        if (band_out)
+            band_out[i] = static_cast<std::uint16_t>(engine.powerband());
+    }
+};
+
+extern "C" {
+
+TACHSIM_API std::uint32_t tachsim_abi_version(void)
+{
+    return TACHSIM_ABI_VERSION;
+}
+
+TACHSIM_API int tachsim_create(std::uint64_t seed, tachsim_simulator** out)
+{
+    if (!out)
+        return TACHSIM_ERR_NULL;
+    *out = new (std::nothrow) tachsim_simulator(seed);
+    return *out ? TACHSIM_OK : TACHSIM_ERR_ALLOC;
+}
+
+TACHSIM_API void tachsim_destroy(tachsim_simulator* sim)
+{
+    delete sim;
+}
+
+TACHSIM_API int tachsim_reset(tachsim_simulator* sim, std::uint64_t seed)
+{
+    if (!sim)
+        return TACHSIM_ERR_NULL;
+    *sim = tachsim_simulator(seed);
+    return TACHSIM_OK;
+}
+
+TACHSIM_API int tachsim_classify_omega(const double* omega, std::size_t count,
+                                       std::int32_t* rpm_out, std::uint16_t* band_out)
+{
+    if (!omega && count > 0)
+        return TACHSIM_ERR_NULL;
+
+    EnginePowerModel engine;
+    engine.set_verbose(false);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        engine.update_from_rpm(omega[i]);
+        if (rpm_out)
+            rpm_out[i] = engine.filtered_rpm();
+        if (band_out)
+            band_out[i] = static_cast<std::uint16_t>(engine.powerband());
+    }
+    return TACHSIM_OK;
+}
+
+TACHSIM_API int tachsim_sanitize_omega(const double* omega, std::size_t count, double sample_seconds,
+                                       double max_rpm, double max_slew_rpm_per_sec,
+                                       double* omega_out, std::uint8_t* flags_out)
+{
+    if ((!omega || !omega_out || !flags_out) && count > 0)
+        return TACHSIM_ERR_NULL;
+    if (!(sample_seconds > 0.0) || !(max_rpm > 0.0) || !(max_slew_rpm_per_sec > 0.0))
+        return TACHSIM_ERR_ARGUMENT;
+
+    // Work in RPM, which is what the limits are expressed in, then convert back.
+    constexpr double rpm_per_rad_s = 60.0 / (2.0 * 3.141592653589793);
+    for (std::size_t i = 0; i < count; ++i)
+        omega_out[i] = omega[i] * rpm_per_rad_s;
+
+    SanitizeLimits limits;
+    limits.max_rpm              = max_rpm;
+    limits.max_slew_rpm_per_sec = max_slew_rpm_per_sec;
+    sanitize_rpm(omega_out, count, sample_seconds, limits, omega_out, flags_out);
+
+    for (std::size_t i = 0; i < count; ++i)
+        omega_out[i] /= rpm_per_rad_s;
+    return TACHSIM_OK;
+}
+
+TACHSIM_API int tachsim_run_ticks(tachsim_simulator* sim, std::size_t ticks, double delta_seconds,
+                                  std::int32_t* rpm_out, std::uint16_t* band_out)
+{
+    if (!sim)
+        return TACHSIM_ERR_NULL;
+    if (!(delta_seconds >= 0.0))
+        return TACHSIM_ERR_ARGUMENT;
+
+    for (std::size_t i = 0; i < ticks; ++i)
+        sim->apply(sim->source.next_omega(), delta_seconds, rpm_out, band_out, i);
+    return TACHSIM_OK;
+}
+
+TACHSIM_API int tachsim_feed_omega(tachsim_simulator* sim, const double* omega, std::size_t count,
+                                   double delta_seconds, std::int32_t* rpm_out, std::uint16_t* band_out)
+{
+    if (!sim || (!omega && count > 0))
+        return TACHSIM_ERR_NULL;
+    if (!(delta_seconds >= 0.0))
+        return TACHSIM_ERR_ARGUMENT;
+
+    for (std::size_t i = 0; i < count; ++i)
+        sim->apply(omega[i], delta_seconds, rpm_out, band_out, i);
+    return TACHSIM_OK;
+}
+
+TACHSIM_API int tachsim_get_flight_hours(const tachsim_simulator* sim, tachsim_flight_hours* out)
+{
+    if (!sim || !out)
+        return TACHSIM_ERR_NULL;
+
+    *out = tachsim_flight_hours{};
+    out->total_seconds   = sim->hours.total_time();
+    out->caution_seconds = sim->hours.caution_time();
+    out->redline_seconds = sim->hours.redline_time();
+    out->hours           = static_cast<std::int32_t>(sim->hours.hours());
+    out->minutes         = sim->hours.minutes();
+    out->seconds         = sim->hours.seconds();
+    return TACHSIM_OK;
+}
+
+TACHSIM_API int tachsim_get_diagnostics(const tachsim_simulator* sim, tachsim_diagnostics* out)
+{
+    if (!sim || !out)
+        return TACHSIM_ERR_NULL;
+
+    Tachometer_Diagnostic diag = sim->policy.evaluate(sim->hours);
+    *out = tachsim_diagnostics{};
+    out->status       = static_cast<std::int32_t>(diag.status());
+    out->code         = diag.code();
+    out->filtered_rpm = sim->engine.filtered_rpm();
+    out->band         = static_cast<std::uint16_t>(sim->engine.powerband());
+    out->raw_rpm      = sim->engine.raw_rpm();
+    out->ticks        = sim->ticks;
+    return TACHSIM_OK;
+}
+
+} // extern "C"
+
+// -----------------------------------------------------------------------------
+// Synthetic flight-log corpora for benchmarking readers and writers.
+//
+// Output is a sequence of fixed-row chunks. Chunk c draws from its own RNG
+// seeded from (seed, c), so the bytes are identical whatever the thread
+// count. Per wave of chunks: samples are generated in parallel, the running
+// counters (which depend on all earlier rows) are prefix-summed serially from
+// per-chunk totals, rows are formatted in parallel, and a writer thread
+// streams finished chunks to disk in order while the next wave is built.
+// -----------------------------------------------------------------------------
+enum class LogFormat : std::uint16_t
+{
+    Csv = 0 // flight_log.csv layout (FlightHours::csv_header / csv_row).
+};
+
+bool parse_log_format(const std::string& text, LogFormat& format)
+{
+    if (text == "csv")
+    {
+        format = LogFormat::Csv;
+        return true;
+    }
+    return false;
+}
+
+// Accepts plain byte counts or K/M/G/T suffixes (powers of 1024).
+bool parse_byte_size(const std::string& text, std::uint64_t& bytes)
+{
+    char* end = nullptr;
+    double value = std::strtod(text.c_str(), &end);
+    if (!end || end == text.c_str() || !(value > 0.0))
+        return false;
+    double scale = 1.0;
+    switch (*end)
+    {
+    case '\0':           break;
+    case 'K': case 'k':  scale = 1024.0; break;
+    case 'M': case 'm':  scale = 1024.0 * 1024.0; break;
+    case 'G': case 'g':  scale = 1024.0 * 1024.0 * 1024.0; break;
+    case 'T': case 't':  scale = 1024.0 * 1024.0 * 1024.0 * 1024.0; break;
+    default:             return false;
+    }
+    bytes = static_cast<std::uint64_t>(value * scale);
+    return true;
+}
+
+struct GeneratorConfig
+{
+    std::string   output_path{ "synthetic_log.csv" };
+    LogFormat     format{ LogFormat::Csv };
+    std::uint64_t target_bytes{ 1ull << 20 };
+    std::uint64_t seed{ 1 };
+    // Relative weight of each EnginePowerBand, PowerOff (below idle) first.
+    double        band_mix[7]{ 5, 15, 25, 35, 12, 6, 2 };
+    double        mean_dwell_ticks{ 10.0 }; // Average run length in one band.
+    double        noise{ 0.05 };            // RPM jitter, as a fraction of the band width.
+    double        delta_seconds{ 60.0 };
+    std::size_t   threads{ 0 };             // 0 = hardware concurrency.
+    std::string   catalog_path;             // Empty = do not catalog the output.
+};
+
+bool parse_band_mix(const std::string& text, double (&mix)[7])
+{
+    double parsed[7];
+    const char* p = text.c_str();
+    for (int b = 0; b < 7; ++b)
+    {
+        char* end = nullptr;
+        parsed[b] = std::strtod(p, &end);
+        if (end == p || parsed[b] < 0.0 || (b < 6 && *end != ',') || (b == 6 && *end != '\0'))
+            return false;
+        p = end + 1;
+    }
+    std::copy(std::begin(parsed), std::end(parsed), std::begin(mix));
+    return true;
+}
+
+class SyntheticLogGenerator
+{
+public:
+    explicit SyntheticLogGenerator(const GeneratorConfig& config)
+        : config_(config)
+        , run_rng_(config.seed)
+        , dwell_(1.0 / std::max(config.mean_dwell_ticks, 1.0))
+    {
+        double total = 0.0;
+        for (double w : config_.band_mix)
+            total += w;
+        double acc = 0.0;
+        for (int b = 0; b < 7; ++b)
+        {
+            acc += total > 0.0 ? config_.band_mix[b] / total : (b == 3 ? 1.0 : 0.0);
+            cumulative_[b] = acc;
+        }
+        cumulative_[6] = 1.0;
+
+        // RPM range per band, PowerOff uses the below-idle range of RPMSource.
+        const BandProfile p = BandProfile::standard();
+        range_[0][0] = 0;             range_[0][1] = 900;
+        range_[1][0] = p.idle_min;    range_[1][1] = p.climb_min - 1;
+        range_[2][0] = p.climb_min;   range_[2][1] = p.cruise_min - 1;
+        range_[3][0] = p.cruise_min;  range_[3][1] = p.caution_min - 1;
+        range_[4][0] = p.caution_min; range_[4][1] = p.redline_min - 1;
+        range_[5][0] = p.redline_min; range_[5][1] = p.redline_max;
+        range_[6][0] = p.redline_max + 1; range_[6][1] = 11000;
+    }
+
+    int run()
+    {
+        using clock = std::chrono::steady_clock;
+
+        int fd = ::open(config_.output_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+        {
+            std::cerr << "Generator: cannot open " << config_.output_path << ": " << std::strerror(errno) << "\n";
+            return 1;
+        }
+
+        std::size_t threads = config_.threads ? config_.threads : std::max(1u, std::thread::hardware_concurrency());
+        WorkerPool pool(threads);
+        const std::size_t wave = 2 * threads;
+        const auto start = clock::now();
+
+        // Writer thread: takes formatted chunks in order, bounded to two waves in flight.
+        std::deque<std::string> ready;
+        std::mutex              ready_mutex;
+        std::condition_variable ready_cv;
+        bool                    done_producing = false;
+        bool                    write_failed = false;
+        std::uint64_t           written = 0;
+        BlockChecksummer        sums;
+
+        std::thread writer([&] {
+            for (;;)
+            {
+                std::string chunk;
+                {
+                    std::unique_lock<std::mutex> lock(ready_mutex);
+                    ready_cv.wait(lock, [&] { return !ready.empty() || done_producing; });
+                    if (ready.empty())
+                        return;
+                    chunk = std::move(ready.front());
+                    ready.pop_front();
+                    sim_metrics().queue_depth.set(static_cast<double>(ready.size()));
+                }
+                ready_cv.notify_all();
+                sums.update(chunk.data(), chunk.size());
+                if (!write_all(fd, chunk.data(), chunk.size()))
+                {
+                    std::lock_guard<std::mutex> lock(ready_mutex);
+                    write_failed = true;
+                }
+                written += chunk.size();
+                sim_metrics().bytes_written.add(chunk.size());
+            }
+        });
+
+        std::string header;
+        if (config_.format == LogFormat::Csv)
+        {
+            std::ostringstream os;
+            FlightHours{}.csv_header(os);
+            header = os.str();
+        }
+        std::uint64_t queued_bytes = header.size(); // The header counts toward --size.
+        queue_chunk(std::move(header), ready, ready_mutex, ready_cv, wave);
+
+        std::vector<ChunkSamples> samples(wave);
+        std::vector<std::string>  text(wave);
+        RunningTotals totals;
+        CatalogRecorder catalog;
+        std::uint64_t rows = 0;
+        std::uint64_t next_chunk = 0;
+
+        while (queued_bytes < config_.target_bytes)
+        {
+            for (std::size_t w = 0; w < wave; ++w)
+                plan_runs(samples[w]);
+            for (std::size_t w = 0; w < wave; ++w)
+                pool.submit([&, w](std::size_t) { generate_chunk(next_chunk + w, samples[w]); });
+            pool.wait_idle();
+
+            // Serial prefix over chunk totals gives every chunk its starting counters.
+            std::vector<RunningTotals> base(wave);
+            for (std::size_t w = 0; w < wave; ++w)
+            {
+                base[w] = totals;
+                totals.tick    += samples[w].rpm.size();
+                totals.running += samples[w].running;
+                totals.caution += samples[w].caution;
+                totals.redline += samples[w].redline;
+            }
+
+            for (std::size_t w = 0; w < wave; ++w)
+                pool.submit([&, w](std::size_t) { format_chunk(samples[w], base[w], text[w]); });
+            pool.wait_idle();
+
+            for (std::size_t w = 0; w < wave && queued_bytes < config_.target_bytes; ++w)
+            {
+                // Cut the final chunk at a row boundary so the file lands on the target size.
+                std::uint64_t remaining = config_.target_bytes - queued_bytes;
+                if (text[w].size() > remaining)
+                {
+                    std::size_t cut = text[w].rfind('\n', static_cast<std::size_t>(remaining) - 1);
+                    text[w].resize(cut == std::string::npos ? text[w].find('\n') + 1 : cut + 1);
+                    std::size_t kept = static_cast<std::size_t>(std::count(text[w].begin(), text[w].end(), '\n'));
+                    rows += kept;
+                    queued_bytes = config_.target_bytes;
+                    tally_rows(samples[w], kept, samples[w].band_ticks, samples[w].max_rpm);
+                    catalog.add_ticks(samples[w].band_ticks, kept, config_.delta_seconds, samples[w].max_rpm);
+                }
+                else
+                {
+                    queued_bytes += text[w].size();
+                    rows += samples[w].rpm.size();
+                    catalog.add_ticks(samples[w].band_ticks, samples[w].rpm.size(), config_.delta_seconds,
+                                      samples[w].max_rpm);
+                }
+                queue_chunk(std::move(text[w]), ready, ready_mutex, ready_cv, wave);
+            }
+            next_chunk += wave;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(ready_mutex);
+            done_producing = true;
+        }
+        ready_cv.notify_all();
+        writer.join();
+        ::close(fd);
+
+        if (write_failed)
+        {
+            std::cerr << "Generator: write to " << config_.output_path << " failed\n";
+            return 1;
+        }
+        sums.finish();
+        std::string error;
+        if (!sums.write_sidecar(config_.output_path, error))
+        {
+            std::cerr << "Generator: " << error << "\n";
+            return 1;
+        }
+        catalog_log(config_.catalog_path,
+                    catalog.entry(config_.output_path, "generate", describe_config(), config_.seed,
+                                  config_.delta_seconds, written));
+        double elapsed = std::chrono::duration<double>(clock::now() - start).count();
+        std::cout << "Generated " << config_.output_path << ": " << rows << " rows, " << written
+                  << " bytes in " << elapsed << " s (" << (elapsed > 0.0 ? written / elapsed / 1e6 : 0.0)
+                  << " MB/s, " << threads << " threads)\n";
+        return 0;
+    }
+
+private:
+    std::string describe_config() const
+    {
+        std::ostringstream os;
+        os << "mix=";
+        for (int b = 0; b < 7; ++b)
+            os << (b ? "," : "") << config_.band_mix[b];
+        os << " dwell=" << config_.mean_dwell_ticks << " noise=" << config_.noise
+           << " delta=" << config_.delta_seconds;
+        return os.str();
+    }
+
+    // One dwell in a band; a dwell that crosses a chunk boundary is split
+    // into a piece per chunk with the same band and setpoint.
+    struct DwellRun
+    {
+        int           band{ 0 };
+        double        setpoint{ 0.0 };
+        std::uint64_t rows{ 0 };
+    };
+
+    struct ChunkSamples
+    {
+        std::vector<DwellRun>        runs;
+        std::vector<std::int32_t>    rpm;
+        std::vector<EnginePowerBand> band;
+        std::uint64_t running{ 0 }, caution{ 0 }, redline{ 0 }; // Ticks in each class.
+        std::uint64_t band_ticks[7]{};
+        std::int32_t  max_rpm{ 0 };
+    };
+
+    // Per-band ticks and peak RPM over the first `rows` samples, for the catalog.
+    static void tally_rows(const ChunkSamples& in, std::size_t rows, std::uint64_t (&ticks)[7], std::int32_t& max_rpm)
+    {
+        std::fill(std::begin(ticks), std::end(ticks), 0);
+        count_power_bands(in.band.data(), nullptr, rows, ticks);
+        max_rpm = 0;
+        for (std::size_t k = 0; k < rows; ++k)
+            max_rpm = std::max(max_rpm, in.rpm[k]);
+    }
+
+    struct RunningTotals
+    {
+        std::uint64_t tick{ 0 }, running{ 0 }, caution{ 0 }, redline{ 0 };
+    };
+
+    static bool write_all(int fd, const char* p, std::size_t n)
+    {
+        while (n > 0)
+        {
+            ssize_t w = ::write(fd, p, n);
+            if (w < 0 && errno == EINTR)
+                continue;
+            if (w <= 0)
+                return false;
+            p += w;
+            n -= static_cast<std::size_t>(w);
+        }
+        return true;
+    }
+
+    static void queue_chunk(std::string chunk, std::deque<std::string>& ready, std::mutex& m,
+                            std::condition_variable& cv, std::size_t limit)
+    {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [&] { return ready.size() < 2 * limit; });
+        ready.push_back(std::move(chunk));
+        lock.unlock();
+        cv.notify_all();
+    }
+
+    // Serial pass: cuts the next chunk's rows into dwell runs from one stream
+    // for the whole file, carrying an unfinished dwell into the next chunk.
+    void plan_runs(ChunkSamples& out)
+    {
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        out.runs.clear();
+        std::uint64_t left = k_chunk_rows;
+        while (left > 0)
+        {
+            if (carry_.rows == 0)
+            {
+                double u = unit(run_rng_);
+                int b = 0;
+                while (b < 6 && u >= cumulative_[b])
+                    ++b;
+                carry_.band = b;
+                carry_.setpoint = range_[b][0] + unit(run_rng_) * (range_[b][1] - range_[b][0]);
+                carry_.rows = dwell_(run_rng_) + 1;
+            }
+            DwellRun piece = carry_;
+            piece.rows = std::min(left, carry_.rows);
+            out.runs.push_back(piece);
+            carry_.rows -= piece.rows;
+            left -= piece.rows;
+        }
+    }
+
+    void generate_chunk(std::uint64_t chunk, ChunkSamples& out) const
+    {
+        // Chunk seeds reuse the fleet seed mixer; chunk index plays the engine index.
+        std::mt19937_64 rng(fleet_engine_seed(config_.seed, chunk));
+        std::normal_distribution<double> jitter(0.0, 1.0);
+
+        const std::size_t n = k_chunk_rows;
+        out.rpm.resize(n);
+        out.band.resize(n);
+        out.running = out.caution = out.redline = 0;
+
+        const BandProfile profile = BandProfile::standard();
+        std::size_t i = 0;
+        for (const DwellRun& run : out.runs)
+        {
+            double lo = range_[run.band][0], hi = range_[run.band][1];
+            double sigma = config_.noise * (hi - lo);
+            for (std::uint64_t k = 0; k < run.rows; ++k, ++i)
+            {
+                double rpm = std::min(std::max(run.setpoint + sigma * jitter(rng), lo), hi);
+                out.rpm[i] = static_cast<std::int32_t>(std::lround(rpm));
+                out.band[i] = profile.classify(out.rpm[i]);
+            }
+        }
+
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            EnginePowerBand band = out.band[k];
+            out.running += band != EnginePowerBand::PowerOff;
+            out.caution += band == EnginePowerBand::Caution;
+            out.redline += band == EnginePowerBand::RedLine || band == EnginePowerBand::OverLimit;
+        }
+        tally_rows(out, n, out.band_ticks, out.max_rpm);
+    }
+
+    // Same columns and semantics as FlightHours::csv_row, formatted with to_chars.
+    void format_chunk(const ChunkSamples& in, const RunningTotals& base, std::string& out) const
+    {
+        const std::int64_t delta = std::lround(config_.delta_seconds);
+        std::uint64_t running = base.running, caution = base.caution, redline = base.redline;
+
+        out.clear();
+        out.reserve(in.rpm.size() * 64);
+        char line[160];
+        for (std::size_t k = 0; k < in.rpm.size(); ++k)
+        {
+            EnginePowerBand band = in.band[k];
+            running += band != EnginePowerBand::PowerOff;
+            caution += band == EnginePowerBand::Caution;
+            redline += band == EnginePowerBand::RedLine || band == EnginePowerBand::OverLimit;
+
+            std::int64_t total = static_cast<std::int64_t>(running) * delta;
+            char* p = line;
+            char* end = line + sizeof(line);
+            auto field = [&](std::int64_t v) {
+                p = std::to_chars(p, end - 1, v).ptr; // Leaves room for the separator.
+                *p++ = ',';
+            };
+            field(static_cast<std::int64_t>(base.tick + k) * delta);
+            field(total);
+            field(total / 3600);
+            field((total % 3600) / 60);
+            field(total % 60);
+            field(in.rpm[k]);
+            const std::string& name = band_names_[static_cast<int>(band)];
+            std::memcpy(p, name.data(), name.size());
+            p += name.size();
+            *p++ = ',';
+            field(static_cast<std::int64_t>(caution) * delta);
+            p = std::to_chars(p, end - 1, static_cast<std::int64_t>(redline) * delta).ptr;
+            *p++ = '\n';
+            out.append(line, static_cast<std::size_t>(p - line));
+        }
+    }
+
+    // Rows per parallel work unit. Fixed so that the jitter streams, which are
+    // seeded per chunk, give the same file for a given seed on any machine.
+    static constexpr std::size_t k_chunk_rows = 65536;
+
+    GeneratorConfig config_;
+    std::mt19937_64 run_rng_;
+    std::geometric_distribution<std::uint64_t> dwell_;
+    DwellRun        carry_;
+    double          cumulative_[7]{};
+    double          range_[7][2]{};
+    std::string     band_names_[7]{
+        to_string(EnginePowerBand::PowerOff), to_string(EnginePowerBand::Idle),
+        to_string(EnginePowerBand::Climb),    to_string(EnginePowerBand::Cruise),
+        to_string(EnginePowerBand::Caution),  to_string(EnginePowerBand::RedLine),
+        to_string(EnginePowerBand::OverLimit) };
+};
+
+// -----------------------------------------------------------------------------
+// Maintenance planning: engines are ranked by the day their verdict is
+// projected to require maintenance, in an indexed min-heap so each new run
+// result re-keys one engine in O(log n). Planning fills hangar slots day by
+// day, most urgent first (earliest-due-date order).
+// -----------------------------------------------------------------------------
+class IndexedMinHeap
+{
+public:
+    static constexpr std::uint32_t npos = 0xFFFFFFFFu;
+
+    explicit IndexedMinHeap(std::size_t capacity)
+        : position_(capacity, npos)
+    {
+        heap_.reserve(capacity);
+    }
+
+    bool          empty() const noexcept                 { return heap_.empty(); }
+    std::size_t   size() const noexcept                  { return heap_.size(); }
+    bool          contains(std::uint32_t id) const       { return position_[id] != npos; }
+    std::uint32_t top() const                            { return heap_.front().id; }
+    double        top_key() const                        { return heap_.front().key; }
+    double        key(std::uint32_t id) const            { return heap_[position_[id]].key; }
+
+    void push_or_update(std::uint32_t id, double key)
+    {
+        if (contains(id))
+        {
+            std::size_t at = position_[id];
+            double old = heap_[at].key;
+            heap_[at].key = key;
+            if (key < old)
+                sift_up(at);
+            else
+                sift_down(at);
+            return;
+        }
+        heap_.push_back(Entry{ key, id });
+        position_[id] = static_cast<std::uint32_t>(heap_.size() - 1);
+        sift_up(heap_.size() - 1);
+    }
+
+    std::uint32_t pop()
+    {
+        std::uint32_t id = heap_.front().id;
+        remove_at(0);
+        return id;
+    }
+
+    void remove(std::uint32_t id)
+    {
+        if (contains(id))
+            remove_at(position_[id]);
+    }
+
+private:
+    struct Entry
+    {
+        double        key;
+        std::uint32_t id;
+    };
+
+    // Ties break on id so plans are reproducible.
+    static bool less(const Entry& a, const Entry& b) noexcept
+    {
+        return a.key < b.key || (a.key == b.key && a.id < b.id);
+    }
+
+    void place(std::size_t at, const Entry& e)
+    {
+        heap_[at] = e;
+        position_[e.id] = static_cast<std::uint32_t>(at);
+    }
+
+    void sift_up(std::size_t at)
+    {
+        Entry e = heap_[at];
+        while (at > 0)
+        {
+            std::size_t parent = (at - 1) / 2;
+            if (!less(e, heap_[parent]))
+                break;
+            place(at, heap_[parent]);
+            at = parent;
+        }
+        place(at, e);
+    }
+
+    void sift_down(std::size_t at)
+    {
+        Entry e = heap_[at];
+        for (;;)
+        {
+            std::size_t child = 2 * at + 1;
+            if (child >= heap_.size())
+                break;
+            if (child + 1 < heap_.size() && less(heap_[child + 1], heap_[child]))
+                ++child;
+            if (!less(heap_[child], e))
+                break;
+            place(at, heap_[child]);
+            at = child;
+        }
+        place(at, e);
+    }
+
+    void remove_at(std::size_t at)
+    {
+        position_[heap_[at].id] = npos;
+        Entry last = heap_.back();
+        heap_.pop_back();
+        if (at == heap_.size())
+            return;
+        place(at, last);
+        sift_up(at);
+        sift_down(position_[last.id]);
+    }
+
+    std::vector<Entry>         heap_;
+    std::vector<std::uint32_t> position_;
+};
+
+struct MaintenanceAssignment
+{
+    std::uint32_t engine;
+    std::uint32_t day;      // Days from the planning date.
+    double        due_day;  // Projected day maintenance becomes required.
+    bool          late;     // Capacity pushed it past its due day.
+};
+
+class MaintenancePlanner
+{
+public:
+    MaintenancePlanner(std::size_t engines, const DiagnosticPolicy& policy, double horizon_days)
+        : policy_(policy),
+          horizon_days_(horizon_days),
+          queue_(engines),
+          state_(engines)
+    {
+    }
+
+    // Feed one engine's hour-meter totals at simulated day `today`. Accumulation
+    // rates are smoothed over days, then projected forward to the first policy
+    // threshold the engine will cross.
+    void record_outcome(std::uint32_t engine, const FlightHours& hours, double today)
+    {
+        EngineState& s = state_[engine];
+        double elapsed = today - s.last_day;
+        if (elapsed > 0.0)
+        {
+            double caution_rate = (hours.caution_time() - s.caution_seconds) / elapsed;
+            double redline_rate = (hours.redline_time() - s.redline_seconds) / elapsed;
+            s.caution_rate = s.samples == 0 ? caution_rate : k_smoothing * caution_rate + (1.0 - k_smoothing) * s.caution_rate;
+            s.redline_rate = s.samples == 0 ? redline_rate : k_smoothing * redline_rate + (1.0 - k_smoothing) * s.redline_rate;
+            ++s.samples;
+        }
+        s.caution_seconds = hours.caution_time();
+        s.redline_seconds = hours.redline_time();
+        s.last_day = today;
+
+        // Remember when maintenance first became required so waiting engines keep
+        // their place. An engine that is already failing on that first day is keyed
+        // a day early so it outranks engines that only became due the same day; a
+        // later failure keeps the original day and does not jump the queue.
+        Diagnostic_Status status = policy_.evaluate(hours).status();
+        if (status != Diagnostic_Status::SystemSuccessful && !(s.required_since <= today))
+            s.required_since = status == Diagnostic_Status::SystemCheckSystemFailure ? today - 1.0 : today;
+        requeue(engine, today);
+    }
+
+    // Engine leaves the hangar with a fresh hour meter.
+    void record_overhaul(std::uint32_t engine, double today)
+    {
+        EngineState& s = state_[engine];
+        s.caution_seconds = 0;
+        s.redline_seconds = 0;
+        s.last_day = today;
+        s.required_since = std::numeric_limits<double>::infinity();
+        requeue(engine, today);
+    }
+
+    // Assign engines due within the horizon to hangar days, most urgent first.
+    // Each engine goes to the latest free day not after its due day, so slots
+    // are not spent on engines long before they need them; only when every day
+    // up to its due day is full does it spill to the first free day after it.
+    // The queue is left unchanged.
+    std::vector<MaintenanceAssignment> plan(double today, std::size_t days, std::size_t slots_per_day)
+    {
+        std::vector<MaintenanceAssignment> plan;
+        std::vector<std::pair<std::uint32_t, double>> taken;
+        std::vector<std::size_t> used(days, 0);
+        std::size_t capacity = days * slots_per_day;
+        while (!queue_.empty() && taken.size() < capacity && queue_.top_key() <= today + horizon_days_)
+        {
+            double due = queue_.top_key();
+            std::uint32_t engine = queue_.pop();
+            taken.emplace_back(engine, due);
+
+            double offset = std::floor(due - today);
+            const std::size_t due_day = offset <= 0.0 ? 0 : std::min(static_cast<std::size_t>(offset), days - 1);
+            std::size_t day = due_day + 1;
+            while (day > 0 && used[day - 1] == slots_per_day)
+                --day;
+            if (day > 0)
+                --day;
+            else
+            {
+                day = due_day + 1;
+                while (day < days && used[day] == slots_per_day)
+                    ++day;
+                if (day == days)
+                    continue; // No slot left anywhere in the window.
+            }
+            ++used[day];
+            plan.push_back(MaintenanceAssignment{ engine, static_cast<std::uint32_t>(day), due, today + day > due });
+        }
+        for (const auto& t : taken)
+            queue_.push_or_update(t.first, t.second);
+
+        std::stable_sort(plan.begin(), plan.end(),
+                         [](const MaintenanceAssignment& a, const MaintenanceAssignment& b) { return a.day < b.day; });
+        return plan;
+    }
+
+    // Engines past their due day as of their last update, whether or not they
+    // got a slot.
+    std::size_t overdue() const noexcept { return overdue_; }
+
+private:
+    struct EngineState
+    {
+        std::int64_t caution_seconds{ 0 };
+        std::int64_t redline_seconds{ 0 };
+        double       caution_rate{ 0.0 }; // Seconds per day.
+        double       redline_rate{ 0.0 };
+        double       last_day{ 0.0 };
+        double       required_since{ std::numeric_limits<double>::infinity() };
+        unsigned     samples{ 0 };
+        bool         overdue{ false };
+    };
+
+    static constexpr double k_smoothing = 0.3; // EWMA weight of the newest day.
+
+    // Re-key the engine and keep the overdue count in step, so callers need not
+    // scan the fleet every simulated day.
+    void requeue(std::uint32_t engine, double today)
+    {
+        EngineState& s = state_[engine];
+        double due = due_day(s, today);
+        queue_.push_or_update(engine, due);
+        bool overdue = due <= today;
+        overdue_ += static_cast<std::size_t>(overdue) - static_cast<std::size_t>(s.overdue);
+        s.overdue = overdue;
+    }
+
+    double due_day(const EngineState& s, double today) const
+    {
+        if (s.required_since <= today)
+            return s.required_since;
+
+        double days = std::numeric_limits<double>::infinity();
+        if (s.redline_rate > 0.0)
+            days = std::min(days, (policy_.maintenance_redline_sec - s.redline_seconds) / s.redline_rate);
+        if (s.caution_rate > 0.0)
+            days = std::min(days, (policy_.maintenance_caution_sec - s.caution_seconds) / s.caution_rate);
+        return today + days;
+    }
+
+    DiagnosticPolicy         policy_;
+    double                   horizon_days_;
+    IndexedMinHeap           queue_;
+    std::vector<EngineState> state_;
+    std::size_t              overdue_{ 0 };
+};
+
+struct MaintenanceConfig
+{
+    FleetConfig fleet;                 // engines, seed, delta, profiles
+    std::size_t days{ 30 };
+    std::size_t slots_per_day{ 50 };
+    std::size_t ticks_per_day{ 600 };  // 10 flight hours at 1-minute ticks.
+    double      horizon_days{ 14.0 };
+};
+
+// Simulates the fleet one day at a time, re-plans after every day and sends
+// the engines scheduled for today to the hangar (hour meter reset).
+int run_maintenance_mode(const MaintenanceConfig& config)
+{
+    using clock = std::chrono::steady_clock;
+
+    DiagnosticPolicy policy;
+    std::vector<FleetEngineRecord> records(config.fleet.engines);
+    init_fleet_records(records.data(), records.size(), config.fleet.seed, 0, config.fleet.profiles);
+    MaintenancePlanner planner(records.size(), policy, config.horizon_days);
+
+    std::uint64_t inducted_total = 0;
+    std::uint64_t late_total = 0;
+    double        worst_replan_ms = 0.0;
+    std::vector<MaintenanceAssignment> plan;
+
+    for (std::size_t day = 1; day <= config.days; ++day)
+    {
+        simulate_fleet_ticks(records.data(), records.size(), config.ticks_per_day,
+                             config.fleet.delta_seconds, config.fleet.profiles.table, config.fleet.degradation);
+
+        auto replan_start = clock::now();
+        double today = static_cast<double>(day);
+        for (std::uint32_t e = 0; e < records.size(); ++e)
+            planner.record_outcome(e, records[e].hours, today);
+        plan = planner.plan(today, config.horizon_days > 0 ? static_cast<std::size_t>(config.horizon_days) : 1,
+                            config.slots_per_day);
+        double replan_ms = std::chrono::duration<double, std::milli>(clock::now() - replan_start).count();
+        worst_replan_ms = std::max(worst_replan_ms, replan_ms);
+
+        std::size_t inducted = 0;
+        std::size_t late = 0;
+        for (const MaintenanceAssignment& a : plan)
+        {
+            if (a.day != 0)
+                break;
+            records[a.engine].hours = FlightHours{};
+            records[a.engine].damage = 0.0f; // Overhaul restores the profile limits.
+            planner.record_overhaul(a.engine, today);
+            ++inducted;
+            late += a.late;
+        }
+        inducted_total += inducted;
+        late_total += late;
+
+        std::cout << "Day " << day << ": inducted " << inducted << " (" << late << " late), "
+                  << planner.overdue() << " overdue waiting, planned " << plan.size()
+                  << ", re-plan " << replan_ms << " ms\n";
+    }
+
+    std::cout << "Maintenance plan: " << inducted_total << " inductions, " << late_total
+              << " late, worst re-plan " << worst_replan_ms << " ms\n";
+    std::cout << "Upcoming schedule (first " << std::min<std::size_t>(plan.size(), 10) << " slots):\n";
+    for (std::size_t i = 0; i < plan.size() && i < 10; ++i)
+    {
+        std::cout << "  day +" << plan[i].day << ": engine " << plan[i].engine
+                  << " (due day " << plan[i].due_day << (plan[i].late ? ", late" : "") << ")\n";
+    }
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Failure hazard: Weibull proportional hazards on operating age. At age t in
+// band b an engine fails at rate m[b] * h0(t), with h0 the Weibull baseline,
+// so over a stretch of constant multiplier the cumulative hazard is
+// m * (H0(t1) - H0(t0)) and can be inverted in closed form. Each engine draws
+// an Exp(1) hazard budget when it is (re)built and fails where its cumulative
+// hazard crosses it: one pow per segment instead of a Bernoulli trial per tick.
+// -----------------------------------------------------------------------------
+struct HazardModel
+{
+    double shape{ 1.5 };           // Weibull k; above 1 the engine wears out.
+    double scale_hours{ 10000.0 }; // Weibull eta at multiplier 1 (steady Cruise).
+    double multiplier[7]{ 0.0, 0.5, 0.8, 1.0, 2.0, 5.0, 15.0 }; // PowerOff..OverLimit.
+
+    bool valid() const noexcept
+    {
+        if (!(shape > 0.0) || !(scale_hours > 0.0))
+            return false;
+        for (double m : multiplier)
+            if (!(m >= 0.0) || !std::isfinite(m))
+                return false;
+        return true;
+    }
+
+    // Baseline cumulative hazard H0(t) = (t / eta)^k.
+    double baseline(double age_hours) const { return std::pow(age_hours / scale_hours, shape); }
+
+    // Time-weighted multiplier of a stretch known only by its band tick counts.
+    double mixed_multiplier(const std::int64_t (&counts)[7]) const noexcept
+    {
+        double weighted = 0.0;
+        std::int64_t ticks = 0;
+        for (int b = 0; b < 7; ++b)
+        {
+            weighted += multiplier[b] * static_cast<double>(counts[b]);
+            ticks    += counts[b];
+        }
+        return ticks > 0 ? weighted / static_cast<double>(ticks) : 0.0;
+    }
+};
+
+// An engine's position on its failure clock: operating age since it was last
+// rebuilt and the hazard spent against the budget drawn at that point.
+class FailureClock
+{
+public:
+    template <class Rng>
+    void renew(Rng& rng)
+    {
+        age_hours_ = 0.0;
+        spent_     = 0.0;
+        baseline_  = 0.0;
+        budget_    = std::exponential_distribution<double>(1.0)(rng);
+    }
+
+    // Advances through `hours` at a constant hazard multiplier. Returns the
+    // hours into the segment at which the engine fails, or a negative value
+    // if it survives the segment.
+    double advance(const HazardModel& model, double multiplier, double hours)
+    {
+        double end_age      = age_hours_ + hours;
+        double end_baseline = model.baseline(end_age);
+        double hazard       = multiplier * (end_baseline - baseline_);
+        if (spent_ + hazard < budget_)
+        {
+            spent_     += hazard;
+            age_hours_  = end_age;
+            baseline_   = end_baseline;
+            return -1.0;
+        }
+
+        // Inverse CDF on this segment: H0(t) = H0(age) + remaining budget / m.
+        double target   = baseline_ + (budget_ - spent_) / multiplier;
+        double fail_age = model.scale_hours * std::pow(target, 1.0 / model.shape);
+        double offset   = std::min(std::max(fail_age - age_hours_, 0.0), hours);
+        age_hours_ += offset;
+        baseline_   = target;
+        spent_      = budget_;
+        return offset;
+    }
+
+    double age_hours() const noexcept { return age_hours_; }
+
+private:
+    double age_hours_{ 0.0 };
+    double spent_{ 0.0 };
+    double baseline_{ 0.0 };
+    double budget_{ std::numeric_limits<double>::infinity() };
+};
+
+// -----------------------------------------------------------------------------
+// Survival analysis: streaming Kaplan-Meier / Nelson-Aalen over event times.
+// Times are counted into fixed-width bins as they arrive, so an observation is
+// O(1), per-thread instances merge by adding counts, and the curve is built
+// on demand in one pass over the bins. Within a bin events are taken to come
+// before censorings (the usual KM tie rule); bin width sets the resolution.
+// -----------------------------------------------------------------------------
+class SurvivalCurve
+{
+public:
+    struct Point
+    {
+        double        hours;             // Upper edge of the bin.
+        std::uint64_t at_risk;
+        std::uint64_t events;
+        std::uint64_t censored;
+        double        survival;          // Kaplan-Meier S(t).
+        double        std_error;         // Greenwood standard error of S(t).
+        double        cumulative_hazard; // Nelson-Aalen H(t).
+    };
+
+    explicit SurvivalCurve(double bin_hours = 1.0)
+        : bin_hours_{ bin_hours > 0.0 ? bin_hours : 1.0 }
+    {
+    }
+
+    void observe(double hours) { add(hours, events_); }
+    void censor(double hours)  { add(hours, censored_); }
+
+    // Both curves must use the same bin width.
+    void merge(const SurvivalCurve& other)
+    {
+        grow(other.events_.size());
+        for (std::size_t i = 0; i < other.events_.size(); ++i)
+        {
+            events_[i]   += other.events_[i];
+            censored_[i] += other.censored_[i];
+        }
+        subjects_ += other.subjects_;
+    }
+
+    std::uint64_t subjects() const noexcept { return subjects_; }
+
+    // Non-empty bins only.
+    std::vector<Point> curve() const
+    {
+        std::vector<Point> points;
+        std::uint64_t at_risk = subjects_;
+        double survival = 1.0;
+        double greenwood = 0.0;
+        double hazard = 0.0;
+        for (std::size_t i = 0; i < events_.size(); ++i)
+        {
+            std::uint64_t d = events_[i];
+            std::uint64_t c = censored_[i];
+            if (d == 0 && c == 0)
+                continue;
+            if (d > 0 && at_risk > 0)
+            {
+                double n = static_cast<double>(at_risk);
+                survival  *= 1.0 - static_cast<double>(d) / n;
+                hazard    += static_cast<double>(d) / n;
+                greenwood += at_risk > d ? static_cast<double>(d) / (n * (n - static_cast<double>(d))) : 0.0;
+            }
+            points.push_back(Point{ static_cast<double>(i + 1) * bin_hours_, at_risk, d, c, survival,
+                                    survival * std::sqrt(greenwood), hazard });
+            at_risk -= d + c;
+        }
+        return points;
+    }
+
+    // First time S(t) drops to 0.5 or below; negative if it never does.
+    double median() const
+    {
+        for (const Point& p : curve())
+            if (p.survival <= 0.5)
+                return p.hours;
+        return -1.0;
+    }
+
+    void write_csv(std::ostream& os, const std::string& name) const
+    {
+        for (const Point& p : curve())
+            os << name << ',' << p.hours << ',' << p.at_risk << ',' << p.events << ',' << p.censored << ','
+               << p.survival << ',' << p.std_error << ',' << p.cumulative_hazard << '\n';
+    }
+
+    static void csv_header(std::ostream& os)
+    {
+        os << "curve,hours,at_risk,events,censored,survival,std_error,cumulative_hazard\n";
+    }
+
+private:
+    void add(double hours, std::vector<std::uint64_t>& counts)
+    {
+        std::size_t bin = static_cast<std::size_t>(std::max(hours, 0.0) / bin_hours_);
+        grow(bin + 1);
+        ++counts[bin];
+        ++subjects_;
+    }
+
+    void grow(std::size_t bins)
+    {
+        if (bins > events_.size())
+        {
+            events_.resize(bins, 0);
+            censored_.resize(bins, 0);
+        }
+    }
+
+    double                     bin_hours_;
+    std::vector<std::uint64_t> events_;
+    std::vector<std::uint64_t> censored_;
+    std::uint64_t              subjects_{ 0 };
+};
+
+// Curves a lifecycle run produces; one instance per worker, merged at the end.
+struct LifecycleSurvival
+{
+    SurvivalCurve maintenance; // Flight hours from overhaul to the next scheduled overhaul.
+    SurvivalCurve failure;     // Operating age at unscheduled failure.
+
+    explicit LifecycleSurvival(double bin_hours = 1.0)
+        : maintenance(bin_hours), failure(bin_hours)
+    {
+    }
+
+    void merge(const LifecycleSurvival& other)
+    {
+        maintenance.merge(other.maintenance);
+        failure.merge(other.failure);
+    }
+};
+
+// -----------------------------------------------------------------------------
+// Lifecycle: each engine flies a sequence of flights separated by ground time
+// until it reaches its life limit. Hours since overhaul are kept in a
+// FlightHours, checked by the DiagnosticPolicy after every flight and reset
+// when the verdict calls for maintenance; lifetime totals keep accumulating.
+//
+// RPMSource draws a band independently on every tick, so the band counts of
+// an n-tick flight are multinomial. Most flights are booked from those counts
+// (six binomial draws) instead of n samples. Every detail_every-th flight is
+// run tick by tick through the engine model and can be logged.
+// -----------------------------------------------------------------------------
+// Binomial draw by inversion: a sequential search from k = 0, O(n p) steps.
+// Per-flight band counts have small means, where this is several times
+// cheaper than std::binomial_distribution (which re-initializes per call).
+inline std::int64_t sample_binomial(std::mt19937_64& rng, std::int64_t n, double p)
+{
+    if (n <= 0 || p <= 0.0)
+        return 0;
+    if (p >= 1.0)
+        return n;
+    if (p > 0.5)
+        return n - sample_binomial(rng, n, 1.0 - p);
+    if (static_cast<double>(n) * p > 100.0)
+        return std::binomial_distribution<std::int64_t>(n, p)(rng);
+
+    // 1 / (k + 1) for the search steps; a divide per step would dominate.
+    static const std::vector<double> reciprocal = [] {
+        std::vector<double> r(512);
+        for (std::size_t k = 0; k < r.size(); ++k)
+            r[k] = 1.0 / static_cast<double>(k + 1);
+        return r;
+    }();
+
+    const double q = 1.0 - p;
+    const double odds = p / q;
+    double prob = std::pow(q, static_cast<double>(n));
+    double cdf = prob;
+    double u = std::generate_canonical<double, 53>(rng);
+    std::int64_t k = 0;
+    while (u > cdf && k < n)
+    {
+        double step = k < static_cast<std::int64_t>(reciprocal.size()) ? reciprocal[k] : 1.0 / static_cast<double>(k + 1);
+        prob *= odds * static_cast<double>(n - k) * step;
+        cdf += prob;
+        ++k;
+    }
+    return k;
+}
+
+struct LifecycleConfig
+{
+    std::uint64_t engines{ 100 };
+    std::uint64_t seed{ 1 };
+    double        life_hours{ 20000.0 };     // Flight hours at which an engine is retired.
+    double        mean_flight_hours{ 3.0 };  // Flight length is uniform in [0.5, 1.5] x mean.
+    double        mean_ground_hours{ 16.0 }; // Exponential turnaround between flights.
+    double        delta_seconds{ 60.0 };
+    std::uint64_t detail_every{ 0 };         // Tick-level flights: every N-th flight, 0 = none.
+    std::string   detail_path;               // Optional CSV of the tick-level flights.
+    std::size_t   threads{ 0 };              // 0 = hardware concurrency.
+    DegradationModel degradation;            // Derates the standard profile between overhauls.
+    bool          sample_failures{ false };  // Draw unscheduled removals from `hazard`.
+    HazardModel   hazard;
+    std::string   survival_path;             // Optional Kaplan-Meier / Nelson-Aalen CSV.
+    double        survival_bin_hours{ 1.0 };
+};
+
+struct EngineLifecycle
+{
+    std::uint64_t flights{ 0 };
+    std::uint64_t detail_flights{ 0 };
+    std::uint64_t overhauls{ 0 };
+    std::uint64_t failures{ 0 };        // Overhauls forced by a failure verdict.
+    std::int64_t  flight_seconds{ 0 };  // Lifetime time on wing, all bands.
+    std::int64_t  ground_seconds{ 0 };
+    std::int64_t  caution_seconds{ 0 }; // Lifetime totals, across overhauls.
+    std::int64_t  redline_seconds{ 0 };
+    std::int32_t  max_derate_rpm{ 0 };  // Deepest threshold drop reached before an overhaul.
+    std::uint64_t unscheduled{ 0 };     // Removals after a sampled in-flight failure.
+    double        failure_age_hours{ 0.0 }; // Operating age summed over those failures.
+};
+
+class LifecycleSimulator
+{
+public:
+    explicit LifecycleSimulator(const LifecycleConfig& config)
+        : config_(config),
+          tick_seconds_{ std::max<std::int64_t>(1, std::lround(config.delta_seconds)) }
+    {
+        config_.degradation.max_derate_rpm = std::min(config_.degradation.max_derate_rpm,
+                                                      max_safe_derate(BandProfileTable::standard()));
+    }
+
+    // One engine's whole life; depends only on the fleet seed and `engine`.
+    // Rows of tick-level flights are appended to `detail` when it is non-null;
+    // maintenance and failure times go to `survival`, censored at retirement.
+    EngineLifecycle simulate_engine(std::uint64_t engine, std::string* detail,
+                                    LifecycleSurvival* survival = nullptr) const
+    {
+        std::mt19937_64 rng(fleet_engine_seed(config_.seed, engine));
+        std::uniform_real_distribution<double> flight_scale(0.5, 1.5);
+        std::exponential_distribution<double>  ground_hours(1.0 / std::max(config_.mean_ground_hours, 1e-9));
+
+        const std::int64_t life_seconds = std::llround(config_.life_hours * 3600.0);
+        const double mean_ticks = config_.mean_flight_hours * 3600.0 / static_cast<double>(tick_seconds_);
+
+        const DegradationModel& model = config_.degradation;
+        const float  tick_hours = static_cast<float>(tick_seconds_) / 3600.0f;
+        const double hazard_tick_hours = static_cast<double>(tick_seconds_) / 3600.0;
+
+        EngineLifecycle life;
+        FlightHours     since_overhaul;
+        TickTally       tally;
+        float           damage = 0.0f;
+        std::int32_t    derate = 0;
+        double          probability[7];
+        std::copy(std::begin(RPMSource::band_probability), std::end(RPMSource::band_probability), probability);
+        FailureClock    clock;
+        std::int64_t    since_overhaul_seconds = 0;
+        std::vector<std::pair<EnginePowerBand, std::int64_t>> runs;
+        if (config_.sample_failures)
+            clock.renew(rng);
+
+        while (life.flight_seconds < life_seconds)
+        {
+            std::int64_t ticks = std::max<std::int64_t>(1, std::llround(mean_ticks * flight_scale(rng)));
+            std::int64_t caution_before = since_overhaul.caution_time();
+            std::int64_t redline_before = since_overhaul.redline_time();
+            std::int64_t counts[7] = {};
+
+            if (config_.detail_every > 0 && life.flights % config_.detail_every == 0)
+            {
+                fly_detailed(engine, life, static_cast<std::uint32_t>(rng()), ticks,
+                             BandProfile::standard().derated(derate), counts, runs, since_overhaul, tally, detail);
+                ++life.detail_flights;
+            }
+            else
+                fly_summarized(rng, ticks, probability, counts, since_overhaul, tally);
+
+            // Damage is booked per flight; the derate applies from the next flight on.
+            if (model.enabled())
+            {
+                damage += tick_hours * (model.redline_weight * static_cast<float>(counts[5])
+                                      + model.overlimit_weight * static_cast<float>(counts[6]));
+                std::int32_t next = model.derate(damage);
+                if (next != derate)
+                {
+                    derate = next;
+                    RPMSource::band_probabilities(BandProfile::standard().derated(derate), probability);
+                    life.max_derate_rpm = std::max(life.max_derate_rpm, derate);
+                }
+            }
+
+            life.caution_seconds += since_overhaul.caution_time() - caution_before;
+            life.redline_seconds += since_overhaul.redline_time() - redline_before;
+            life.flight_seconds  += ticks * tick_seconds_;
+            since_overhaul_seconds += ticks * tick_seconds_;
+            ++life.flights;
+
+            // Summarized flights are one hazard segment at their mixed multiplier;
+            // tick-level flights are walked band run by band run.
+            bool failed = false;
+            if (config_.sample_failures)
+            {
+                if (runs.empty())
+                    failed = clock.advance(config_.hazard, config_.hazard.mixed_multiplier(counts),
+                                           static_cast<double>(ticks) * hazard_tick_hours) >= 0.0;
+                for (const auto& run : runs)
+                {
+                    failed = clock.advance(config_.hazard, config_.hazard.multiplier[static_cast<int>(run.first)],
+                                           static_cast<double>(run.second) * hazard_tick_hours) >= 0.0;
+                    if (failed)
+                        break;
+                }
+                runs.clear();
+            }
+            if (failed)
+            {
+                // The engine finishes the flight shut down and goes to the shop: rebuilt, clock renewed.
+                ++life.unscheduled;
+                life.failure_age_hours += clock.age_hours();
+                if (survival)
+                    survival->failure.observe(clock.age_hours());
+                clock.renew(rng);
+            }
+
+            Diagnostic_Status status = policy_.evaluate(since_overhaul).status();
+            if (failed || status != Diagnostic_Status::SystemSuccessful)
+            {
+                life.overhauls += !failed;
+                life.failures  += !failed && status == Diagnostic_Status::SystemCheckSystemFailure;
+                if (survival)
+                {
+                    // A failure ends the interval for another reason: censored.
+                    double hours = static_cast<double>(since_overhaul_seconds) / 3600.0;
+                    if (failed)
+                        survival->maintenance.censor(hours);
+                    else
+                        survival->maintenance.observe(hours);
+                }
+                since_overhaul_seconds = 0;
+                since_overhaul = FlightHours{};
+                if (derate != 0)
+                    std::copy(std::begin(RPMSource::band_probability), std::end(RPMSource::band_probability),
+                              probability);
+                damage = 0.0f;
+                derate = 0;
+            }
+            if (config_.mean_ground_hours > 0.0)
+                life.ground_seconds += std::llround(ground_hours(rng) * 3600.0);
+        }
+        if (survival)
+        {
+            survival->maintenance.censor(static_cast<double>(since_overhaul_seconds) / 3600.0);
+            if (config_.sample_failures)
+                survival->failure.censor(clock.age_hours());
+        }
+        tally.flush();
+        return life;
+    }
+
+private:
+    // Band counts of an n-tick flight as sequential binomials (conditional
+    // multinomial). Rare bands go first so every draw has a small mean; the
+    // last band (Cruise) takes the remainder.
+    void fly_summarized(std::mt19937_64& rng, std::int64_t ticks, const double (&probability)[7],
+                        std::int64_t (&counts)[7], FlightHours& hours, TickTally& tally) const
+    {
+        static constexpr int order[7] = { 6, 0, 5, 4, 1, 2, 3 };
+        std::int64_t remaining = ticks;
+        double remaining_p = 1.0;
+        for (int i = 0; i < 7 && remaining > 0; ++i)
+        {
+            int b = order[i];
+            std::int64_t count = remaining;
+            if (i < 6)
+                count = sample_binomial(rng, remaining, std::min(1.0, probability[b] / remaining_p));
+            remaining   -= count;
+            remaining_p -= probability[b];
+            counts[b]    = count;
+
+            std::int64_t seconds = count * tick_seconds_;
+            hours.add_band_seconds(static_cast<EnginePowerBand>(b), seconds);
+            tally.band_seconds[b] += static_cast<std::uint64_t>(seconds);
+        }
+        tally.ticks += static_cast<std::uint64_t>(ticks);
+    }
+
+    void fly_detailed(std::uint64_t engine, const EngineLifecycle& life, std::uint32_t source_seed,
+                      std::int64_t ticks, const BandProfile& profile, std::int64_t (&counts)[7],
+                      std::vector<std::pair<EnginePowerBand, std::int64_t>>& runs,
+                      FlightHours& hours, TickTally& tally, std::string* detail) const
+    {
+        RPMSource        source(source_seed);
+        EnginePowerModel model;
+        model.set_verbose(false);
+        std::ostringstream os;
+
+        for (std::int64_t t = 0; t < ticks; ++t)
+        {
+            EnginePowerBand previous = model.powerband();
+            model.update_from_rpm(source.next_omega(), profile);
+            hours.flight_log_hours(model, static_cast<double>(tick_seconds_));
+            tally.add(previous, model.powerband(), model.sample_valid() ? tick_seconds_ : 0);
+            counts[static_cast<int>(model.powerband())] += model.sample_valid();
+            if (config_.sample_failures)
+            {
+                if (runs.empty() || runs.back().first != model.powerband())
+                    runs.emplace_back(model.powerband(), 0);
+                ++runs.back().second;
+            }
+            if (detail)
+            {
+                os << engine << ',' << life.flights << ',';
+                hours.csv_row(os, model, static_cast<double>(life.flight_seconds + t * tick_seconds_));
+            }
+        }
+        if (detail)
+            *detail += os.str();
+    }
+
+    LifecycleConfig  config_;
+    std::int64_t     tick_seconds_;
+    DiagnosticPolicy policy_;
+};
+
+// Simulates every engine's life in parallel and prints fleet aging totals.
+int run_lifecycle_mode(const LifecycleConfig& config)
+{
+    using clock = std::chrono::steady_clock;
+
+    if (config.engines == 0 || !(config.life_hours > 0.0) || !(config.mean_flight_hours > 0.0)
+        || !(config.delta_seconds >= 1.0))
+    {
+        std::cerr << "Lifecycle: engines, life hours and flight hours must be positive, delta at least 1 s\n";
+        return 1;
+    }
+    if (config.sample_failures && !config.hazard.valid())
+    {
+        std::cerr << "Lifecycle: Weibull shape and scale must be positive, multipliers non-negative\n";
+        return 1;
+    }
+
+    LifecycleSimulator simulator(config);
+    std::vector<EngineLifecycle> lives(config.engines);
+    std::vector<std::string>     detail(config.detail_path.empty() ? 0 : config.engines);
+
+    std::size_t threads = config.threads ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+    WorkerPool pool(threads);
+    constexpr std::uint64_t chunk = 16;
+    const bool want_survival = !config.survival_path.empty();
+    std::vector<LifecycleSurvival> survival(want_survival ? threads : 0,
+                                            LifecycleSurvival(config.survival_bin_hours));
+
+    auto start = clock::now();
+    for (std::uint64_t first = 0; first < config.engines; first += chunk)
+    {
+        pool.submit([&, first](std::size_t worker) {
+            std::uint64_t last = std::min(first + chunk, config.engines);
+            for (std::uint64_t e = first; e < last; ++e)
+                lives[e] = simulator.simulate_engine(e, detail.empty() ? nullptr : &detail[e],
+                                                     want_survival ? &survival[worker] : nullptr);
+        });
+    }
+    pool.wait_idle();
+    double elapsed = std::chrono::duration<double>(clock::now() - start).count();
+
+    if (want_survival)
+    {
+        for (std::size_t w = 1; w < survival.size(); ++w)
+            survival[0].merge(survival[w]);
+        ChecksummedLogFile out{ config.survival_path };
+        if (!out)
+        {
+            std::cerr << "Lifecycle: cannot write " << config.survival_path << "\n";
+            return 1;
+        }
+        SurvivalCurve::csv_header(out);
+        survival[0].maintenance.write_csv(out, "maintenance");
+        if (config.sample_failures)
+            survival[0].failure.write_csv(out, "failure");
+        std::string error;
+        if (!out.close(error))
+        {
+            std::cerr << "Lifecycle: " << error << "\n";
+            return 1;
+        }
+    }
+
+    if (!config.detail_path.empty())
+    {
+        ChecksummedLogFile out{ config.detail_path };
+        if (!out)
+        {
+            std::cerr << "Lifecycle: cannot write " << config.detail_path << "\n";
+            return 1;
+        }
+        out << "engine,flight,";
+        FlightHours{}.csv_header(out);
+        for (const std::string& rows : detail)
+            out << rows;
+        std::string error;
+        if (!out.close(error))
+        {
+            std::cerr << "Lifecycle: " << error << "\n";
+            return 1;
+        }
+    }
+
+    EngineLifecycle total;
+    std::uint64_t min_overhauls = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t max_overhauls = 0;
+    std::uint64_t engines_failed = 0;
+    for (const EngineLifecycle& life : lives)
+    {
+        total.unscheduled       += life.unscheduled;
+        total.failure_age_hours += life.failure_age_hours;
+        engines_failed          += life.unscheduled > 0;
+        total.flights         += life.flights;
+        total.detail_flights  += life.detail_flights;
+        total.overhauls       += life.overhauls;
+        total.failures        += life.failures;
+        total.flight_seconds  += life.flight_seconds;
+        total.ground_seconds  += life.ground_seconds;
+        total.caution_seconds += life.caution_seconds;
+        total.redline_seconds += life.redline_seconds;
+        min_overhauls = std::min(min_overhauls, life.overhauls);
+        max_overhauls = std::max(max_overhauls, life.overhauls);
+    }
+
+    const double n = static_cast<double>(config.engines);
+    std::cout << "Lifecycle: " << config.engines << " engines, " << config.life_hours << " h life, seed "
+              << config.seed << "\n";
+    std::cout << "  flights            " << total.flights << " (" << total.detail_flights << " tick-level)\n"
+              << "  flight hours/engine " << total.flight_seconds / 3600.0 / n << "\n"
+              << "  ground hours/engine " << total.ground_seconds / 3600.0 / n << "\n"
+              << "  overhauls/engine    " << total.overhauls / n << " (min " << min_overhauls
+              << ", max " << max_overhauls << ", " << total.failures << " after failure verdicts)\n"
+              << "  caution hours/engine " << total.caution_seconds / 3600.0 / n << "\n"
+              << "  redline hours/engine " << total.redline_seconds / 3600.0 / n << "\n";
+    if (config.sample_failures)
+    {
+        std::cout << "  unscheduled/engine   " << total.unscheduled / n << " ("
+                  << 100.0 * engines_failed / n << " % of engines failed before the life limit)\n";
+        if (total.unscheduled > 0)
+            std::cout << "  mean age at failure  " << total.failure_age_hours / total.unscheduled << " h\n";
+    }
+    if (want_survival)
+    {
+        std::cout << "  median to maintenance " << survival[0].maintenance.median() << " h";
+        if (config.sample_failures)
+            std::cout << ", median to failure " << survival[0].failure.median() << " h";
+        std::cout << " (curves in " << config.survival_path << ")\n";
+    }
+    if (config.degradation.enabled())
+    {
+        double deepest = 0.0;
+        for (const EngineLifecycle& life : lives)
+            deepest += life.max_derate_rpm;
+        std::cout << "  peak derate (rpm)    " << deepest / n << " mean\n";
+    }
+    std::cout << "  elapsed " << elapsed * 1000.0 << " ms (" << elapsed * 1000.0 / n << " ms per engine, "
+              << threads << " threads)\n";
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Ensemble: many Monte-Carlo realizations of the standard run, summarized per
+// tick by streaming P² quantile estimators (Jain & Chlamtac) instead of
+// stored traces. Each estimator is five markers, so the whole fan chart costs
+// a few dozen bytes per tick and series however many runs are made.
+// -----------------------------------------------------------------------------
+class P2Quantile
+{
+public:
+    void add(double x, double p) noexcept
+    {
+        if (count_ < 5)
+        {
+            // Keep the first five sorted; they seed the markers.
+            int i = count_++;
+            while (i > 0 && q_[i - 1] > x)
+            {
+                q_[i] = q_[i - 1];
+                --i;
+            }
+            q_[i] = x;
+            for (int k = 0; k < 5; ++k)
+                n_[k] = k + 1;
+            return;
+        }
+
+        int cell;
+        if (x < q_[0])
+        {
+            q_[0] = x;
+            cell = 0;
+        }
+        else if (x >= q_[4])
+        {
+            q_[4] = std::max(q_[4], x);
+            cell = 3;
+        }
+        else
+        {
+            cell = 0;
+            while (cell < 3 && x >= q_[cell + 1])
+                ++cell;
+        }
+        for (int k = cell + 1; k < 5; ++k)
+            ++n_[k];
+        ++count_;
+
+        // Desired marker positions follow from the count alone.
+        const double fraction[5] = { 0.0, p / 2.0, p, (1.0 + p) / 2.0, 1.0 };
+        for (int k = 1; k < 4; ++k)
+        {
+            double desired = 1.0 + (count_ - 1) * fraction[k];
+            double d = desired - n_[k];
+            if ((d >= 1.0 && n_[k + 1] - n_[k] > 1) || (d <= -1.0 && n_[k - 1] - n_[k] < -1))
+            {
+                int s = d > 0.0 ? 1 : -1;
+                double candidate = parabolic(k, s);
+                if (!(q_[k - 1] < candidate && candidate < q_[k + 1]))
+                    candidate = q_[k] + s * (q_[k + s] - q_[k]) / (n_[k + s] - n_[k]);
+                q_[k] = candidate;
+                n_[k] += s;
+            }
+        }
+    }
+
+    // Current estimate of the p-quantile (exact while fewer than five samples).
+    double value(double p) const noexcept
+    {
+        if (count_ >= 5)
+            return q_[2];
+        if (count_ == 0)
+            return 0.0;
+        return q_[std::min(count_ - 1, static_cast<int>(std::lround(p * (count_ - 1))))];
+    }
+
+private:
+    double parabolic(int k, int s) const noexcept
+    {
+        double span = n_[k + 1] - n_[k - 1];
+        return q_[k] + s / span
+             * ((n_[k] - n_[k - 1] + s) * (q_[k + 1] - q_[k]) / (n_[k + 1] - n_[k])
+                + (n_[k + 1] - n_[k] - s) * (q_[k] - q_[k - 1]) / (n_[k] - n_[k - 1]));
+    }
+
+    double       q_[5]{};  // Marker heights.
+    std::int32_t n_[5]{};  // Marker positions (1-based ranks).
+    std::int32_t count_{ 0 };
+};
+
+struct EnsembleConfig
+{
+    std::uint64_t runs{ 1000 };
+    std::uint64_t ticks{ 50 * 60 };
+    std::uint64_t seed{ 1 };
+    double        delta_seconds{ 60.0 };
+    std::size_t   threads{ 0 };      // 0 = hardware concurrency.
+    std::string   csv_path{ "ensemble_fan.csv" };
+    std::string   svg_path;          // Empty = no chart.
+};
+
+class EnsembleSimulator
+{
+public:
+    static constexpr int    k_series = 3; // Cumulative caution s, cumulative redline s, RPM.
+    static constexpr int    k_levels = 3;
+    static constexpr double k_p[k_levels] = { 0.05, 0.50, 0.95 };
+
+    explicit EnsembleSimulator(const EnsembleConfig& config)
+        : config_(config),
+          estimators_(config.ticks * k_series * k_levels)
+    {
+    }
+
+    // Simulates the runs in waves. A wave's traces are produced in parallel,
+    // then fed to the estimators in run order by workers that each own a
+    // range of ticks, so the result does not depend on the thread count.
+    void run(std::size_t threads)
+    {
+        const std::uint64_t wave = std::max<std::uint64_t>(threads * 32, 64);
+        std::vector<float> traces(wave * config_.ticks * k_series);
+        WorkerPool pool(threads);
+        for (std::uint64_t first = 0; first < config_.runs; first += wave)
+        {
+            const std::uint64_t count = std::min(wave, config_.runs - first);
+            for (std::uint64_t r = 0; r < count; ++r)
+                pool.submit([&, r](std::size_t) { simulate(first + r, &traces[r * config_.ticks * k_series]); });
+            pool.wait_idle();
+
+            for (std::size_t w = 0; w < threads; ++w)
+            {
+                pool.submit([&, w](std::size_t) {
+                    std::uint64_t lo = config_.ticks * w / threads;
+                    std::uint64_t hi = config_.ticks * (w + 1) / threads;
+                    for (std::uint64_t r = 0; r < count; ++r)
+                    {
+                        const float* trace = &traces[r * config_.ticks * k_series];
+                        for (std::uint64_t t = lo; t < hi; ++t)
+                            for (int s = 0; s < k_series; ++s)
+                                for (int l = 0; l < k_levels; ++l)
+                                    estimator(t, s, l).add(trace[t * k_series + s], k_p[l]);
+                    }
+                });
+            }
+            pool.wait_idle();
+        }
+    }
+
+    double quantile(std::uint64_t tick, int series, int level) const
+    {
+        return estimator(tick, series, level).value(k_p[level]);
+    }
+
+    std::size_t state_bytes() const noexcept { return estimators_.size() * sizeof(P2Quantile); }
+
+    void write_csv(std::ostream& os) const
+    {
+        static const char* names[k_series] = { "caution", "redline", "rpm" };
+        os << "time_step";
+        for (const char* name : names)
+            os << ',' << name << "_p5," << name << "_p50," << name << "_p95";
+        os << '\n';
+        // The series are whole seconds and RPM, so two decimals is already more than the estimate carries.
+        char value[32];
+        for (std::uint64_t t = 0; t < config_.ticks; ++t)
+        {
+            os << t * config_.delta_seconds;
+            for (int s = 0; s < k_series; ++s)
+                for (int l = 0; l < k_levels; ++l)
+                {
+                    std::snprintf(value, sizeof(value), ",%.2f", quantile(t, s, l));
+                    os << value;
+                }
+            os << '\n';
+        }
+    }
+
+    // One panel per series: shaded p5..p95 band with the median on top.
+    void write_svg(std::ostream& os) const
+    {
+        static const char* titles[k_series] = { "Cumulative caution (h)", "Cumulative redline/overlimit (h)", "RPM" };
+        static const double scale[k_series] = { 1.0 / 3600.0, 1.0 / 3600.0, 1.0 };
+        const double width = 800.0, panel = 220.0, margin = 50.0;
+        const double hours = config_.ticks * config_.delta_seconds / 3600.0;
+
+        char buf[96];
+        os << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << width + 2 * margin << "\" height=\""
+           << k_series * (panel + margin) + margin << "\" font-family=\"sans-serif\" font-size=\"12\">\n";
+        for (int s = 0; s < k_series; ++s)
+        {
+            double top = margin + s * (panel + margin);
+            double y_max = 0.0;
+            for (std::uint64_t t = 0; t < config_.ticks; ++t)
+                y_max = std::max(y_max, quantile(t, s, 2) * scale[s]);
+            y_max = y_max > 0.0 ? y_max * 1.05 : 1.0;
+
+            auto x_of = [&](std::uint64_t t) { return margin + width * (config_.ticks > 1 ? double(t) / (config_.ticks - 1) : 0.0); };
+            auto y_of = [&](double v) { return top + panel - panel * std::min(std::max(v * scale[s] / y_max, 0.0), 1.0); };
+
+            os << "<text x=\"" << margin << "\" y=\"" << top - 8 << "\">" << titles[s] << "</text>\n";
+            os << "<rect x=\"" << margin << "\" y=\"" << top << "\" width=\"" << width << "\" height=\"" << panel
+               << "\" fill=\"none\" stroke=\"#888\"/>\n";
+            std::snprintf(buf, sizeof(buf), "%.4g", y_max);
+            os << "<text x=\"4\" y=\"" << top + 12 << "\">" << buf << "</text>\n"
+               << "<text x=\"4\" y=\"" << top + panel << "\">0</text>\n";
+
+            os << "<polygon fill=\"#9ecae1\" stroke=\"none\" points=\"";
+            for (std::uint64_t t = 0; t < config_.ticks; ++t)
+                os << x_of(t) << ',' << y_of(quantile(t, s, 2)) << ' ';
+            for (std::uint64_t t = config_.ticks; t-- > 0;)
+                os << x_of(t) << ',' << y_of(quantile(t, s, 0)) << ' ';
+            os << "\"/>\n<polyline fill=\"none\" stroke=\"#08519c\" stroke-width=\"1.5\" points=\"";
+            for (std::uint64_t t = 0; t < config_.ticks; ++t)
+                os << x_of(t) << ',' << y_of(quantile(t, s, 1)) << ' ';
+            os << "\"/>\n";
+        }
+        std::snprintf(buf, sizeof(buf), "%.4g", hours);
+        os << "<text x=\"" << margin + width - 80 << "\" y=\"" << k_series * (panel + margin) + 20 << "\">"
+           << buf << " h (p5/p50/p95)</text>\n</svg>\n";
+    }
+
+private:
+    P2Quantile& estimator(std::uint64_t tick, int series, int level)
+    {
+        return estimators_[(tick * k_series + series) * k_levels + level];
+    }
+    const P2Quantile& estimator(std::uint64_t tick, int series, int level) const
+    {
+        return estimators_[(tick * k_series + series) * k_levels + level];
+    }
+
+    // Same loop as the standard run, with a per-run seed from the fleet mixer.
+    void simulate(std::uint64_t run, float* trace) const
+    {
+        EnginePowerModel engine;
+        FlightHours      hours;
+        RPMSource        source{ fleet_engine_seed(config_.seed, run) };
+        engine.set_verbose(false);
+        for (std::uint64_t t = 0; t < config_.ticks; ++t)
+        {
+            source.drive_engine(engine);
+            hours.flight_log_hours(engine, config_.delta_seconds);
+            trace[t * k_series + 0] = static_cast<float>(hours.caution_time());
+            trace[t * k_series + 1] = static_cast<float>(hours.redline_time());
+            trace[t * k_series + 2] = static_cast<float>(engine.filtered_rpm());
+        }
+    }
+
+    EnsembleConfig          config_;
+    std::vector<P2Quantile> estimators_;
+};
+
+int run_ensemble_mode(const EnsembleConfig& config)
+{
+    using clock = std::chrono::steady_clock;
+    std::size_t threads = config.threads ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+    EnsembleSimulator ensemble(config);
+    const auto start = clock::now();
+    ensemble.run(threads);
+    double elapsed = std::chrono::duration<double>(clock::now() - start).count();
+
+    std::string error;
+    ChecksummedLogFile csv{ config.csv_path };
+    if (!csv)
+    {
+        std::cerr << "Ensemble: cannot write " << config.csv_path << "\n";
+        return 1;
+    }
+    ensemble.write_csv(csv);
+    if (!csv.close(error))
+    {
+        std::cerr << "Ensemble: " << error << "\n";
+        return 1;
+    }
+    if (!config.svg_path.empty())
+    {
+        ChecksummedLogFile svg{ config.svg_path };
+        if (!svg)
+        {
+            std::cerr << "Ensemble: cannot write " << config.svg_path << "\n";
+            return 1;
+        }
+        ensemble.write_svg(svg);
+        if (!svg.close(error))
+        {
+            std::cerr << "Ensemble: " << error << "\n";
+            return 1;
+        }
+    }
+
+    double trace_bytes = double(config.runs) * config.ticks * EnsembleSimulator::k_series * sizeof(float);
+    std::cout << "Ensemble: " << config.runs << " runs x " << config.ticks << " ticks in " << elapsed << " s ("
+              << threads << " threads)\n"
+              << "  estimator state " << ensemble.state_bytes() / 1e6 << " MB (full traces would be "
+              << trace_bytes / 1e6 << " MB)\n";
+    char line[128];
+    std::snprintf(line, sizeof(line), "  %8s  %24s  %24s\n", "hour", "caution h p5/p50/p95", "redline h p5/p50/p95");
+    std::cout << line;
+    const std::uint64_t step = std::max<std::uint64_t>(1, config.ticks / 5);
+    for (std::uint64_t t = step - 1; t < config.ticks; t += step)
+    {
+        std::snprintf(line, sizeof(line), "  %8.1f  %7.2f %7.2f %7.2f  %8.2f %7.2f %7.2f\n",
+                      (t + 1) * config.delta_seconds / 3600.0,
+                      ensemble.quantile(t, 0, 0) / 3600.0, ensemble.quantile(t, 0, 1) / 3600.0,
+                      ensemble.quantile(t, 0, 2) / 3600.0, ensemble.quantile(t, 1, 0) / 3600.0,
+                      ensemble.quantile(t, 1, 1) / 3600.0, ensemble.quantile(t, 1, 2) / 3600.0);
+        std::cout << line;
+    }
+    std::cout << "Fan chart written to " << config.csv_path
+              << (config.svg_path.empty() ? "" : " and " + config.svg_path) << "\n";
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Paired policy comparison. Every variant (band limits plus diagnostic policy)
+// sees the same RPM stream on each run (common random numbers), so the
+// run-to-run noise cancels in the differences. Optionally runs come in
+// antithetic pairs, the second replaying the first seed with every uniform
+// mirrored, and the pair average is one observation.
+// -----------------------------------------------------------------------------
+struct PolicyVariant
+{
+    std::string      name;
+    BandProfile      profile;
+    DiagnosticPolicy policy;
+};
+
+// Band limits idle_min, climb_min, cruise_min, caution_min, redline_min,
+// redline_max (RPM) and policy limits maint_caution_h, maint_redline_h,
+// fail_redline_h (hours). Returns false for an unknown key.
+bool apply_policy_setting(const std::string& key, double value, BandProfile& profile, DiagnosticPolicy& policy)
+{
+    int seconds = static_cast<int>(std::lround(value * DiagnosticPolicy::one_hour));
+    if (key == "idle_min")             profile.idle_min    = static_cast<std::int32_t>(value);
+    else if (key == "climb_min")       profile.climb_min   = static_cast<std::int32_t>(value);
+    else if (key == "cruise_min")      profile.cruise_min  = static_cast<std::int32_t>(value);
+    else if (key == "caution_min")     profile.caution_min = static_cast<std::int32_t>(value);
+    else if (key == "redline_min")     profile.redline_min = static_cast<std::int32_t>(value);
+    else if (key == "redline_max")     profile.redline_max = static_cast<std::int32_t>(value);
+    else if (key == "maint_caution_h") policy.maintenance_caution_sec = seconds;
+    else if (key == "maint_redline_h") policy.maintenance_redline_sec = seconds;
+    else if (key == "fail_redline_h")  policy.failure_redline_sec = seconds;
+    else
+        return false;
+    return true;
+}
+
+// "name" or "name:key=value,..." with the keys of apply_policy_setting.
+bool parse_policy_variant(const std::string& text, PolicyVariant& out, std::string& error)
+{
+    PolicyVariant v;
+    std::size_t colon = text.find(':');
+    v.name = text.substr(0, colon);
+    if (v.name.empty())
+    {
+        error = "variant '" + text + "' has no name";
+        return false;
+    }
+    for (std::size_t start = colon == std::string::npos ? text.size() : colon + 1; start < text.size(); )
+    {
+        std::size_t comma = text.find(',', start);
+        if (comma == std::string::npos)
+            comma = text.size();
+        std::string item = text.substr(start, comma - start);
+        start = comma + 1;
+
+        std::size_t eq = item.find('=');
+        char* end = nullptr;
+        double value = eq == std::string::npos ? 0.0 : std::strtod(item.c_str() + eq + 1, &end);
+        if (eq == std::string::npos || end == item.c_str() + eq + 1 || *end != '\0')
+        {
+            error = "bad setting '" + item + "' in variant " + v.name;
+            return false;
+        }
+        std::string key = item.substr(0, eq);
+        if (!apply_policy_setting(key, value, v.profile, v.policy))
+        {
+            error = "unknown setting '" + key + "' in variant " + v.name;
+            return false;
+        }
+    }
+    if (!v.profile.valid())
+    {
+        error = "variant " + v.name + " has overlapping band limits";
+        return false;
+    }
+    out = v;
+    return true;
+}
+
+// Mean and variance by Welford's update; merge() combines partials (Chan et al.).
+struct RunningMoments
+{
+    double n{ 0.0 };
+    double mean{ 0.0 };
+    double m2{ 0.0 };
+
+    void add(double x) noexcept
+    {
+        n += 1.0;
+        double d = x - mean;
+        mean += d / n;
+        m2 += d * (x - mean);
+    }
+
+    void merge(const RunningMoments& o) noexcept
+    {
+        if (o.n == 0.0)
+            return;
+        double total = n + o.n;
+        double d = o.mean - mean;
+        mean += d * o.n / total;
+        m2 += o.m2 + d * d * n * o.n / total;
+        n = total;
+    }
+
+    double variance() const noexcept { return n > 1.0 ? m2 / (n - 1.0) : 0.0; }
+};
+
+struct CrnConfig
+{
+    std::uint64_t runs{ 2000 };      // Simulated paths per variant.
+    std::uint64_t ticks{ 50 * 60 };
+    std::uint64_t seed{ 1 };
+    double        delta_seconds{ 60.0 };
+    bool          antithetic{ false };
+    bool          independent{ false }; // Give each variant its own stream instead (for reference).
+    std::size_t   threads{ 0 };
+    std::vector<PolicyVariant> variants;
+};
+
+class PolicyComparison
+{
+public:
+    static constexpr int k_metrics = 4; // Caution h, redline h, maintenance-or-worse, failure.
+
+    explicit PolicyComparison(const CrnConfig& config)
+        : config_(config)
+    {
+    }
+
+    // Observations are accumulated in fixed blocks and the block partials are
+    // merged in order, so the numbers do not depend on the thread count.
+    void run(std::size_t threads)
+    {
+        const std::uint64_t paths_per_obs = config_.antithetic ? 2 : 1;
+        const std::uint64_t observations = std::max<std::uint64_t>(config_.runs / paths_per_obs, 1);
+        const std::uint64_t block = 64;
+        const std::uint64_t blocks = (observations + block - 1) / block;
+
+        std::vector<Partial> partials(blocks, Partial(config_.variants.size()));
+        WorkerPool pool(threads);
+        for (std::uint64_t b = 0; b < blocks; ++b)
+        {
+            pool.submit([&, b](std::size_t) {
+                std::vector<std::array<double, k_metrics>> obs(config_.variants.size()), path(config_.variants.size());
+                for (std::uint64_t o = b * block; o < std::min(observations, (b + 1) * block); ++o)
+                {
+                    for (auto& row : obs)
+                        row.fill(0.0);
+                    for (std::uint64_t k = 0; k < paths_per_obs; ++k)
+                    {
+                        simulate(o, k == 1, path);
+                        for (std::size_t v = 0; v < config_.variants.size(); ++v)
+                            for (int m = 0; m < k_metrics; ++m)
+                            {
+                                partials[b].per_path[v][m].add(path[v][m]);
+                                obs[v][m] += path[v][m] / paths_per_obs;
+                            }
+                    }
+                    for (std::size_t v = 0; v < config_.variants.size(); ++v)
+                        for (int m = 0; m < k_metrics; ++m)
+                        {
+                            partials[b].level[v][m].add(obs[v][m]);
+                            partials[b].diff[v][m].add(obs[v][m] - obs[0][m]);
+                        }
+                }
+            });
+        }
+        pool.wait_idle();
+
+        total_ = Partial(config_.variants.size());
+        for (const Partial& p : partials)
+            total_.merge(p);
+    }
+
+    void print(std::ostream& os) const
+    {
+        static const char* metrics[k_metrics] = { "caution hours", "redline hours", "P(maintenance+)", "P(failure)" };
+        const std::size_t nv = config_.variants.size();
+        const double paths = total_.per_path[0][0].n;
+        const double observations = total_.level[0][0].n;
+        char line[200];
+
+        os << "Policy comparison: " << static_cast<std::uint64_t>(paths) << " paths per variant, "
+           << (config_.independent ? "independent streams" : "common random numbers")
+           << (config_.antithetic ? ", antithetic pairs" : "") << "\n";
+        for (std::size_t v = 0; v < nv; ++v)
+        {
+            std::snprintf(line, sizeof(line), "  %-14s", config_.variants[v].name.c_str());
+            os << line;
+            for (int m = 0; m < k_metrics; ++m)
+            {
+                std::snprintf(line, sizeof(line), "  %s %.4f", metrics[m], total_.level[v][m].mean);
+                os << line;
+            }
+            os << "\n";
+        }
+
+        // Half-width of a 95% interval, and what independent runs of the same
+        // size would have given (sum of the per-path variances).
+        for (std::size_t v = 1; v < nv; ++v)
+        {
+            os << "  " << config_.variants[v].name << " - " << config_.variants[0].name << ":\n";
+            std::snprintf(line, sizeof(line), "    %-16s %12s %12s %12s %10s\n", "metric", "difference", "95% +/-",
+                          "indep. +/-", "var ratio");
+            os << line;
+            for (int m = 0; m < k_metrics; ++m)
+            {
+                const RunningMoments& d = total_.diff[v][m];
+                double half = 1.96 * std::sqrt(d.variance() / observations);
+                double indep = 1.96 * std::sqrt((total_.per_path[v][m].variance() + total_.per_path[0][m].variance()) / paths);
+                char ratio[32] = "-"; // Both designs exact: the variants never differ here.
+                if (half > 0.0)
+                    std::snprintf(ratio, sizeof(ratio), "%.1f", (indep * indep) / (half * half));
+                std::snprintf(line, sizeof(line), "    %-16s %12.5f %12.5f %12.5f %10s\n", metrics[m], d.mean, half,
+                              indep, ratio);
+                os << line;
+            }
+        }
+    }
+
+private:
+    struct Partial
+    {
+        explicit Partial(std::size_t variants = 0)
+            : level(variants), diff(variants), per_path(variants)
+        {
+        }
+
+        void merge(const Partial& o)
+        {
+            for (std::size_t v = 0; v < level.size(); ++v)
+                for (int m = 0; m < k_metrics; ++m)
+                {
+                    level[v][m].merge(o.level[v][m]);
+                    diff[v][m].merge(o.diff[v][m]);
+                    per_path[v][m].merge(o.per_path[v][m]);
+                }
+        }
+
+        std::vector<std::array<RunningMoments, k_metrics>> level;    // Per observation.
+        std::vector<std::array<RunningMoments, k_metrics>> diff;     // Observation minus variant 0.
+        std::vector<std::array<RunningMoments, k_metrics>> per_path; // Per simulated path.
+    };
+
+    // One path through all variants. With common random numbers one omega per
+    // tick drives every variant; `mirrored` is the antithetic twin.
+    void simulate(std::uint64_t observation, bool mirrored, std::vector<std::array<double, k_metrics>>& out) const
+    {
+        const std::size_t nv = config_.variants.size();
+        std::vector<EnginePowerModel> engines(nv);
+        std::vector<FlightHours>      hours(nv);
+        std::vector<RPMSource>        sources;
+        const std::size_t streams = config_.independent ? nv : 1;
+        for (std::size_t s = 0; s < streams; ++s)
+        {
+            sources.emplace_back(fleet_engine_seed(config_.seed + 0x9E3779B97F4A7C15ull * s, observation));
+            sources.back().set_antithetic(mirrored);
+        }
+        for (EnginePowerModel& engine : engines)
+            engine.set_verbose(false);
+
+        for (std::uint64_t t = 0; t < config_.ticks; ++t)
+        {
+            double omega = sources[0].next_omega();
+            for (std::size_t v = 0; v < nv; ++v)
+            {
+                if (config_.independent && v > 0)
+                    omega = sources[v].next_omega();
+                engines[v].update_from_rpm(omega, config_.variants[v].profile);
+                hours[v].flight_log_hours(engines[v], config_.delta_seconds);
+            }
+        }
+        for (std::size_t v = 0; v < nv; ++v)
+        {
+            int code = config_.variants[v].policy.evaluate(hours[v]).code();
+            out[v] = { hours[v].caution_time() / 3600.0, hours[v].redline_time() / 3600.0,
+                       code >= 1 ? 1.0 : 0.0, code >= 2 ? 1.0 : 0.0 };
+        }
+    }
+
+    CrnConfig config_;
+    Partial   total_;
+};
+
+int run_policy_comparison(const CrnConfig& config)
+{
+    using clock = std::chrono::steady_clock;
+    std::size_t threads = config.threads ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+    PolicyComparison comparison(config);
+    const auto start = clock::now();
+    comparison.run(threads);
+    double elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    comparison.print(std::cout);
+    std::cout << "  (" << elapsed << " s, " << threads << " threads)\n";
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Sharded fleet: K worker processes each simulate a contiguous engine range and
+// publish into their own slot of a shared anonymous mapping. The parent merges
+// the slots, relaunches shards whose worker crashed, and reports any range that
+// still could not be simulated.
+// -----------------------------------------------------------------------------
+constexpr std::size_t k_shard_histogram_bins = 32; // 1-hour bins, last bin is open-ended.
+
+struct ShardSlot
+{
+    std::atomic<std::uint32_t> state;        // ShardState
+    std::uint32_t              attempts;
+    std::uint32_t              shard;        // Index in the slot array.
+    std::uint64_t              first_engine;
+    std::uint64_t              engine_count;
+    std::atomic<std::uint64_t> engines_done; // Progress, readable while the worker runs.
+    FleetSummary               summary;
+    std::uint64_t              caution_hours[k_shard_histogram_bins];
+    std::uint64_t              redline_hours[k_shard_histogram_bins];
+    std::uint64_t              heatmap_invalid; // Cells live after the slot array, one block per shard.
+    TickTally                  metrics;         // Worker's tick counters, folded into the parent's on success.
+};
+
+enum ShardState : std::uint32_t
+{
+    ShardPending = 0,
+    ShardRunning = 1,
+    ShardDone    = 2
+};
+
+struct ShardConfig
+{
+    FleetConfig   fleet;
+    std::size_t   processes{ 4 };
+    std::size_t   retries{ 1 };          // Relaunches per crashed shard.
+    std::size_t   worker_mem_mb{ 0 };    // 0 = no address-space cap.
+    long          inject_crash{ -1 };    // Testing aid (TACHSIM_INJECT_CRASH): shard that aborts on its first attempt.
+};
+
+std::size_t histogram_bin(std::int64_t seconds)
+{
+    std::size_t hour = static_cast<std::size_t>(std::max<std::int64_t>(seconds, 0) / DiagnosticPolicy::one_hour);
+    return std::min(hour, k_shard_histogram_bins - 1);
+}
+
+// Body of a worker process. Only touches its own slot and heatmap block.
+void run_shard_worker(ShardSlot& slot, std::uint64_t* heat_cells, const ShardConfig& config)
+{
+    slot.state.store(ShardRunning);
+    const TickTally metrics_start = TickTally::snapshot();
+    if (config.inject_crash >= 0 && slot.attempts == 1 && slot.shard == static_cast<std::uint64_t>(config.inject_crash))
+        std::abort();
+
+    DiagnosticPolicy policy;
+    constexpr std::size_t chunk = 1024; // Bounds per-worker memory regardless of shard size.
+    std::vector<FleetEngineRecord> records(std::min<std::uint64_t>(chunk, slot.engine_count));
+    MissionHeatmap heatmap = config.fleet.make_heatmap();
+    MissionHeatmap* map = heat_cells ? &heatmap : nullptr;
+
+    for (std::uint64_t done = 0; done < slot.engine_count; )
+    {
+        std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(chunk, slot.engine_count - done));
+        init_fleet_records(records.data(), n, config.fleet.seed, slot.first_engine + done, config.fleet.profiles);
+        simulate_fleet_ticks(records.data(), n, config.fleet.ticks, config.fleet.delta_seconds,
+                             config.fleet.profiles.table, config.fleet.degradation, map);
+        slot.summary.merge(summarize_fleet(records.data(), n, policy));
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            ++slot.caution_hours[histogram_bin(records[i].hours.caution_time())];
+            ++slot.redline_hours[histogram_bin(records[i].hours.redline_time())];
+        }
+        done += n;
+        slot.engines_done.store(done, std::memory_order_release);
+    }
+    if (map)
+    {
+        std::copy(heatmap.data(), heatmap.data() + heatmap.size(), heat_cells);
+        slot.heatmap_invalid = heatmap.invalid();
+    }
+    slot.metrics = TickTally::snapshot().since(metrics_start);
+    slot.state.store(ShardDone, std::memory_order_release);
+}
+
+pid_t launch_shard(ShardSlot& slot, std::uint64_t* heat_cells, std::size_t heat_size, const ShardConfig& config)
+{
+    // Reset the slot so a relaunch does not double count a crashed attempt.
+    slot.state.store(ShardPending);
+    slot.engines_done.store(0);
+    slot.summary = FleetSummary{};
+    std::fill(std::begin(slot.caution_hours), std::end(slot.caution_hours), 0);
+    std::fill(std::begin(slot.redline_hours), std::end(slot.redline_hours), 0);
+    slot.heatmap_invalid = 0;
+    slot.metrics = TickTally{};
+    if (heat_cells)
+        std::fill(heat_cells, heat_cells + heat_size, 0);
+    ++slot.attempts;
+
+    std::cout.flush();
+    pid_t pid = ::fork();
+    if (pid < 0)
+    {
+        std::cerr << "Shard " << slot.shard << ": cannot fork: " << std::strerror(errno) << "\n";
+        return -1;
+    }
+    if (pid == 0)
+    {
+        if (config.worker_mem_mb > 0)
+        {
+            rlimit limit{};
+            limit.rlim_cur = limit.rlim_max = static_cast<rlim_t>(config.worker_mem_mb) << 20;
+            ::setrlimit(RLIMIT_AS, &limit);
+        }
+        run_shard_worker(slot, heat_cells, config);
+        ::_exit(0);
+    }
+    return pid;
+}
+
+int run_sharded_fleet(const ShardConfig& config)
+{
+    std::size_t shards = std::max<std::size_t>(1, std::min<std::uint64_t>(config.processes, config.fleet.engines));
+
+    MissionHeatmap heatmap = config.fleet.make_heatmap();
+    const std::size_t heat_size = config.fleet.heatmap_path.empty() ? 0 : heatmap.size();
+    const std::size_t shared_bytes = shards * (sizeof(ShardSlot) + heat_size * sizeof(std::uint64_t));
+    void* shared = ::mmap(nullptr, shared_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED)
+    {
+        std::cerr << "Shard: cannot map shared region: " << std::strerror(errno) << "\n";
+        return 1;
+    }
+    ShardSlot* slots = static_cast<ShardSlot*>(shared);
+    std::uint64_t* heat_base = reinterpret_cast<std::uint64_t*>(slots + shards);
+    auto heat_cells = [&](std::size_t s) { return heat_size ? heat_base + s * heat_size : nullptr; };
+
+    // Balanced contiguous ranges: sizes differ by at most one and, since
+    // shards <= engines, none is empty.
+    const std::uint64_t engines = config.fleet.engines;
+    std::vector<pid_t> pids(shards, -1);
+    std::size_t running = 0;
+    for (std::size_t s = 0; s < shards; ++s)
+    {
+        ShardSlot* slot = new (&slots[s]) ShardSlot{};
+        slot->shard        = static_cast<std::uint32_t>(s);
+        slot->first_engine = engines * s / shards;
+        slot->engine_count = engines * (s + 1) / shards - slot->first_engine;
+        pids[s] = launch_shard(*slot, heat_cells(s), heat_size, config);
+        running += pids[s] >= 0; // A shard that could not be forked is reported as failed below.
+    }
+
+    // Reap workers; relaunch any shard whose worker died before publishing.
+    while (running > 0)
+    {
+        int status = 0;
+        pid_t pid = ::waitpid(-1, &status, 0);
+        if (pid < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        auto it = std::find(pids.begin(), pids.end(), pid);
+        if (it == pids.end())
+            continue;
+        std::size_t s = static_cast<std::size_t>(it - pids.begin());
+        ShardSlot& slot = slots[s];
+
+        bool clean = WIFEXITED(status) && WEXITSTATUS(status) == 0 && slot.state.load() == ShardDone;
+        if (!clean && slot.attempts <= config.retries)
+        {
+            std::cerr << "Shard " << s << " (engines " << slot.first_engine << "-"
+                      << slot.first_engine + slot.engine_count - 1 << ") died after "
+                      << slot.engines_done.load() << " engines; relaunching\n";
+            pids[s] = launch_shard(slot, heat_cells(s), heat_size, config);
+            if (pids[s] >= 0)
+                continue;
+        }
+        if (clean)
+            slot.metrics.flush(); // The worker's counters died with it; a live exporter sees each shard land.
+        pids[s] = -1;
+        --running;
+    }
+
+    FleetSummary total;
+    std::uint64_t caution_hours[k_shard_histogram_bins] = {};
+    std::uint64_t redline_hours[k_shard_histogram_bins] = {};
+    std::uint64_t lost = 0;
+    for (std::size_t s = 0; s < shards; ++s)
+    {
+        const ShardSlot& slot = slots[s];
+        if (slot.state.load(std::memory_order_acquire) != ShardDone)
+        {
+            lost += slot.engine_count;
+            std::cerr << "Shard " << s << " failed; engines " << slot.first_engine << "-"
+                      << slot.first_engine + slot.engine_count - 1 << " missing from results\n";
+            continue;
+        }
+        total.merge(slot.summary);
+        for (std::size_t b = 0; b < k_shard_histogram_bins; ++b)
+        {
+            caution_hours[b] += slot.caution_hours[b];
+            redline_hours[b] += slot.redline_hours[b];
+        }
+        if (heat_size)
+            heatmap.merge(heat_cells(s), slot.heatmap_invalid);
+    }
+    ::munmap(shared, shared_bytes);
+
+    print_fleet_summary(std::cout, total);
+    std::cout << "Engines per hour bin (caution / redline):\n";
+    for (std::size_t b = 0; b < k_shard_histogram_bins; ++b)
+    {
+        if (caution_hours[b] == 0 && redline_hours[b] == 0)
+            continue;
+        std::cout << "  " << (b + 1 == k_shard_histogram_bins ? ">=" : "") << b << " h: "
+                  << caution_hours[b] << " / " << redline_hours[b] << "\n";
+    }
+    if (heat_size && write_fleet_heatmap(heatmap, config.fleet.heatmap_path) != 0)
+        return 1;
+    return lost == 0 ? 0 : 2;
+}
+
+// -----------------------------------------------------------------------------
+// Live configuration: band limits, band mix and diagnostic policy that the
+// long-running loops (sensor, daemon) pick up without pausing. A reloader
+// thread parses the file and publishes an immutable LiveConfig with one
+// atomic pointer swap. Readers pin the current epoch while they use it and a
+// retired config is freed once every reader has moved past the epoch it was
+// retired in, so the tick path takes no lock and never sees a freed config.
+// -----------------------------------------------------------------------------
+struct LiveConfig
+{
+    BandProfile      profile;
+    DiagnosticPolicy policy;
+    double           band_mix[7]{ 5, 15, 25, 35, 12, 6, 2 }; // Same shares as RPMSource's default.
+    std::uint64_t    generation{ 0 };                         // Set by LiveConfigCell::publish.
+};
+
+// "key = value" lines, '#' comments. Keys are those of apply_policy_setting
+// plus mix = w0,...,w6. Anything not mentioned keeps its default.
+bool load_live_config(const std::string& path, LiveConfig& out, std::string& error)
+{
+    std::ifstream in{ path };
+    if (!in)
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+    LiveConfig config;
+    std::string line;
+    for (int number = 1; std::getline(in, line); ++number)
+    {
+        line = line.substr(0, line.find('#'));
+        line.erase(std::remove_if(line.begin(), line.end(), [](unsigned char c) { return std::isspace(c); }),
+                   line.end());
+        if (line.empty())
+            continue;
+        std::size_t eq = line.find('=');
+        std::string key = line.substr(0, eq);
+        std::string value = eq == std::string::npos ? "" : line.substr(eq + 1);
+        char* end = nullptr;
+        double number_value = std::strtod(value.c_str(), &end);
+        bool ok = key == "mix" ? parse_band_mix(value, config.band_mix)
+                               : !value.empty() && *end == '\0'
+                                     && apply_policy_setting(key, number_value, config.profile, config.policy);
+        if (!ok)
+        {
+            error = path + ":" + std::to_string(number) + ": bad setting '" + line + "'";
+            return false;
+        }
+    }
+    if (!config.profile.valid())
+    {
+        error = path + ": band limits overlap";
+        return false;
+    }
+    out = config;
+    return true;
+}
+
+class LiveConfigCell
+{
+    struct Slot;
+
+public:
+    static constexpr std::size_t k_default_readers = 64;
+
+    // `readers` bounds how many threads may register at once; size it from the
+    // worker count where threads are created per worker.
+    explicit LiveConfigCell(const LiveConfig& initial, std::size_t readers = k_default_readers)
+        : current_(new LiveConfig(initial)),
+          slot_count_(std::max<std::size_t>(readers, 1)),
+          slots_(new Slot[slot_count_])
+    {
+    }
+
+    LiveConfigCell(const LiveConfigCell&) = delete;
+    LiveConfigCell& operator=(const LiveConfigCell&) = delete;
+
+    ~LiveConfigCell()
+    {
+        delete current_.load();
+        for (const Retired& r : retired_)
+            delete r.config;
+    }
+
+    // Each reading thread claims a slot once; -1 when all are taken, and a
+    // ReadGuard must not be made from -1.
+    int register_reader() noexcept
+    {
+        for (std::size_t i = 0; i < slot_count_; ++i)
+        {
+            bool expected = false;
+            if (slots_[i].claimed.compare_exchange_strong(expected, true))
+                return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    void unregister_reader(int slot) noexcept
+    {
+        if (slot >= 0)
+            slots_[slot].claimed.store(false);
+    }
+
+    // Read section: the config stays valid until the guard goes away. The
+    // slot is stamped before the pointer is loaded, so a writer that does
+    // not yet see the stamp has already swapped and this reader gets the new one.
+    class ReadGuard
+    {
+    public:
+        ReadGuard(LiveConfigCell& cell, int slot) noexcept
+            : slot_(cell.slots_[slot])
+        {
+            slot_.epoch.store(cell.epoch_.load());
+            config_ = cell.current_.load();
+        }
+        ~ReadGuard() { slot_.epoch.store(0, std::memory_order_release); }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+        const LiveConfig* operator->() const noexcept { return config_; }
+        const LiveConfig& operator*() const noexcept  { return *config_; }
+
+    private:
+        Slot&             slot_;
+        const LiveConfig* config_;
+    };
+
+    // Swaps `next` in, retires the previous config and frees what no reader can hold.
+    std::uint64_t publish(std::unique_ptr<LiveConfig> next)
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        std::uint64_t generation = ++generation_;
+        next->generation = generation;
+        const LiveConfig* old = current_.exchange(next.release());
+        retired_.push_back(Retired{ epoch_.fetch_add(1), old });
+        reclaim_locked();
+        return generation;
+    }
+
+    void reclaim()
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        reclaim_locked();
+    }
+
+    std::size_t retired() const
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        return retired_.size();
+    }
+
+private:
+    struct alignas(64) Slot
+    {
+        std::atomic<std::uint64_t> epoch{ 0 }; // 0 = not reading.
+        std::atomic<bool>          claimed{ false };
+    };
+
+    struct Retired
+    {
+        std::uint64_t     epoch; // Readers stamped at or before this may still hold it.
+        const LiveConfig* config;
+    };
+
+    void reclaim_locked()
+    {
+        std::uint64_t oldest = std::numeric_limits<std::uint64_t>::max();
+        for (std::size_t i = 0; i < slot_count_; ++i)
+        {
+            std::uint64_t e = slots_[i].epoch.load();
+            if (e != 0)
+                oldest = std::min(oldest, e);
+        }
+        auto keep = std::partition(retired_.begin(), retired_.end(),
+                                   [oldest](const Retired& r) { return r.epoch >= oldest; });
+        for (auto it = keep; it != retired_.end(); ++it)
+            delete it->config;
+        retired_.erase(keep, retired_.end());
+    }
+
+    std::atomic<const LiveConfig*> current_;
+    std::atomic<std::uint64_t>     epoch_{ 1 };
+    std::size_t                    slot_count_;
+    std::unique_ptr<Slot[]>        slots_;
+    mutable std::mutex             writer_mutex_;
+    std::vector<Retired>           retired_;
+    std::uint64_t                  generation_{ 0 };
+};
+
+// Watches the config file's modification time and republishes it on change.
+// A change is loaded only once the mtime has held for a whole interval, so a
+// writer still filling the file is not read half way. A file that fails to
+// parse is reported and the running config is kept.
+class ConfigReloader
+{
+public:
+    ConfigReloader(LiveConfigCell& cell, std::string path, double interval_ms)
+        : cell_(cell),
+          path_(std::move(path)),
+          interval_(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+              std::chrono::duration<double, std::milli>(std::max(interval_ms, 10.0)))),
+          last_mtime_(mtime()),
+          thread_([this] { loop(); })
+    {
+    }
+
+    ~ConfigReloader()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+    }
+
+private:
+    std::int64_t mtime() const
+    {
+        struct stat st{};
+        if (::stat(path_.c_str(), &st) != 0)
+            return -1;
+        return static_cast<std::int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    }
+
+    void loop()
+    {
+        static MetricCounter& reloads = metrics_registry().counter(
+            "tachsim_config_reloads_total", "Live configuration files published.");
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!cv_.wait_for(lock, interval_, [this] { return stopping_; }))
+        {
+            cell_.reclaim();
+            std::int64_t now = mtime();
+            if (now == last_mtime_ || now < 0)
+                continue;
+            if (now != pending_mtime_)
+            {
+                pending_mtime_ = now; // Still changing, or first seen: look again next interval.
+                continue;
+            }
+            last_mtime_ = now;
+
+            std::unique_ptr<LiveConfig> next(new LiveConfig);
+            std::string error;
+            if (!load_live_config(path_, *next, error))
+            {
+                std::cerr << "Config: " << error << " (keeping the running configuration)\n";
+                continue;
+            }
+            std::uint64_t generation = cell_.publish(std::move(next));
+            reloads.add(1);
+            std::cerr << "Config: reloaded " << path_ << " (generation " << generation << ")\n";
+        }
+    }
+
+    LiveConfigCell&                     cell_;
+    std::string                         path_;
+    std::chrono::steady_clock::duration interval_;
+    std::int64_t                        last_mtime_;
+    std::int64_t                        pending_mtime_{ -1 };
+    std::mutex                          mutex_;
+    std::condition_variable             cv_;
+    bool                                stopping_{ false };
+    std::thread                         thread_; // Last: starts once the state above exists.
+};
+
+// -----------------------------------------------------------------------------
+// Simulation daemon: resident worker pool, per-worker record arenas and a
+// result cache, serving fixed-size binary job requests on a Unix socket.
+//
+// Wire format (host byte order, local socket only):
+//   request  = DaemonRequest [+ payload_count doubles of omega for Classify]
+//   response = DaemonResponse [+ payload_count uint16 bands for Classify]
+// A connection may carry any number of requests back to back. Requests are
+// read by the accept/poll thread; each Fleet or Classify job is one pool task,
+// so idle connections never hold a worker.
+// -----------------------------------------------------------------------------
+enum class DaemonJob : std::uint16_t
+{
+    Ping     = 0,
+    Fleet    = 1, // Simulate `engines` engines for `ticks` ticks, return the summary.
+    Classify = 2, // Classify the omega payload, return one band per sample.
+    Shutdown = 3
+};
+
+struct DaemonRequest
+{
+    std::uint32_t magic{ 0 };
+    std::uint16_t version{ 0 };
+    std::uint16_t job{ 0 };
+    std::uint64_t seed{ 0 };
+    std::uint64_t engines{ 0 };
+    std::uint64_t ticks{ 0 };
+    double        delta_seconds{ 60.0 };
+    std::uint64_t payload_count{ 0 };
+};
+
+struct DaemonResponse
+{
+    std::uint32_t magic{ 0 };
+    std::int32_t  status{ 0 };         // 0 ok; -1 bad header, -2 unknown job, -3 payload too large,
+                                       // -4 engines/ticks/delta outside the daemon's limits.
+    std::uint32_t cached{ 0 };         // 1 when served from the result cache.
+    std::uint32_t reserved{ 0 };
+    std::uint64_t payload_count{ 0 };
+    std::uint64_t engines{ 0 };
+    std::uint64_t successful{ 0 };
+    std::uint64_t maintenance{ 0 };
+    std::uint64_t failure{ 0 };
+    std::int64_t  caution_seconds{ 0 };
+    std::int64_t  redline_seconds{ 0 };
+};
+
+constexpr std::uint32_t k_daemon_magic   = 0x314A5354; // "TSJ1"
+constexpr std::uint16_t k_daemon_version = 1;
+constexpr std::uint64_t k_daemon_max_payload = 1ull << 24;
+constexpr int           k_daemon_io_timeout_sec = 5; // A started request must arrive within this; also caps each write.
+
+bool read_exact(int fd, void* buffer, std::size_t bytes)
+{
+    char* p = static_cast<char*>(buffer);
+    while (bytes > 0)
+    {
+        ssize_t n = ::read(fd, p, bytes);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        p += n;
+        bytes -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+bool write_exact(int fd, const void* buffer, std::size_t bytes)
+{
+    const char* p = static_cast<const char*>(buffer);
+    while (bytes > 0)
+    {
+        ssize_t n = ::send(fd, p, bytes, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        p += n;
+        bytes -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+int connect_unix_socket(const std::string& path)
+{
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path))
+        return -1;
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+    {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int listen_unix_socket(const std::string& path, std::string& error)
+{
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path))
+    {
+        error = "socket path too long";
+        return -1;
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    // Only a stale socket from a previous run is removed: never a regular
+    // file, and never a socket that something is still serving on.
+    struct stat st{};
+    if (::lstat(path.c_str(), &st) == 0)
+    {
+        if (!S_ISSOCK(st.st_mode))
+        {
+            error = path + " exists and is not a socket";
+            return -1;
+        }
+        int probe = connect_unix_socket(path);
+        if (probe >= 0)
+        {
+            ::close(probe);
+            error = path + " is in use by another process";
+            return -1;
+        }
+        ::unlink(path.c_str());
+    }
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        error = std::string("socket: ") + std::strerror(errno);
+        return -1;
+    }
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(fd, 128) != 0)
+    {
+        error = "cannot listen on " + path + ": " + std::strerror(errno);
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+struct DaemonConfig
+{
+    std::string socket_path{ "tachsim.sock" };
+    std::size_t workers{ 4 };
+    std::size_t arena_engines{ 1024 }; // Records preallocated per worker.
+    std::size_t cache_entries{ 4096 };
+    std::uint64_t max_engines{ 100000 };  // Per Fleet job; arenas grow to this at most.
+    std::uint64_t max_ticks{ 1000000 };
+    std::string config_path;           // Live config file, reloaded while serving; empty = defaults.
+    double      reload_ms{ 500.0 };
+};
+
+struct DaemonJobTask
+{
+    int                 client{ -1 };
+    DaemonRequest       request;
+    std::vector<double> omega; // Classify payload.
+};
+
+// A connection in the poll set, with whatever part of its next request has
+// arrived. Reads never block the poll thread.
+struct DaemonConnection
+{
+    int                                   fd{ -1 };
+    std::shared_ptr<DaemonJobTask>        task;
+    std::size_t                           received{ 0 }; // Header then payload bytes.
+    std::chrono::steady_clock::time_point started;
+};
+
+class SimulationDaemon
+{
+public:
+    SimulationDaemon(const DaemonConfig& config, const LiveConfig& initial)
+        : config_(config),
+          live_(initial, std::max<std::size_t>(config.workers, 1)), // One reader slot per worker.
+          arenas_(std::max<std::size_t>(config.workers, 1)),
+          band_scratch_(arenas_.size()),
+          readers_(arenas_.size()),
+          pool_(config.workers)
+    {
+        // Warm the arenas up front so the first jobs do not pay for page faults.
+        for (std::vector<FleetEngineRecord>& arena : arenas_)
+        {
+            arena.resize(config.arena_engines);
+            init_fleet_records(arena.data(), arena.size(), 0);
+        }
+        for (int& reader : readers_)
+            reader = live_.register_reader();
+    }
+
+    int run()
+    {
+        std::string error;
+        if (!config_.config_path.empty())
+            reloader_.reset(new ConfigReloader(live_, config_.config_path, config_.reload_ms));
+        listen_fd_ = listen_unix_socket(config_.socket_path, error);
+        if (listen_fd_ < 0)
+        {
+            std::cerr << "Daemon: " << error << "\n";
+            return 1;
+        }
+        if (::pipe(wake_) != 0)
+        {
+            std::cerr << "Daemon: pipe: " << std::strerror(errno) << "\n";
+            ::close(listen_fd_);
+            return 1;
+        }
+        ::fcntl(wake_[0], F_SETFL, O_NONBLOCK);
+        ::fcntl(wake_[1], F_SETFL, O_NONBLOCK);
+        std::cout << "Daemon listening on " << config_.socket_path << " with "
+                  << pool_.size() << " workers\n";
+
+        std::vector<DaemonConnection> idle; // Connections waiting for (the rest of) their next request.
+        std::vector<pollfd> fds;
+        while (!stopping_.load())
+        {
+            take_returned(idle);
+            fds.assign({ pollfd{ listen_fd_, POLLIN, 0 }, pollfd{ wake_[0], POLLIN, 0 } });
+            for (const DaemonConnection& c : idle)
+                fds.push_back(pollfd{ c.fd, POLLIN, 0 });
+            int ready = ::poll(fds.data(), fds.size(), 200);
+
+            char drain[64];
+            while (::read(wake_[0], drain, sizeof(drain)) > 0)
+            {
+            }
+            const auto now = std::chrono::steady_clock::now();
+            std::vector<DaemonConnection> still;
+            for (std::size_t i = 2; i < fds.size(); ++i)
+            {
+                DaemonConnection& c = idle[i - 2];
+                ClientState state = ready > 0 && fds[i].revents ? receive(c) : ClientState::Idle;
+                // A client that stalls mid-request is dropped, not waited on.
+                if (state == ClientState::Idle && c.received > 0
+                    && now - c.started > std::chrono::seconds(k_daemon_io_timeout_sec))
+                    state = ClientState::Closed;
+                if (state == ClientState::Idle)
+                    still.push_back(std::move(c));
+                else if (state == ClientState::Closed)
+                    ::close(c.fd);
+            }
+            idle.swap(still);
+            if (ready > 0 && (fds[0].revents & POLLIN))
+            {
+                int client = ::accept(listen_fd_, nullptr, nullptr);
+                if (client >= 0)
+                {
+                    // Responses are written blocking; a client that stops reading is dropped.
+                    timeval timeout{ k_daemon_io_timeout_sec, 0 };
+                    ::setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+                    idle.push_back(DaemonConnection{ client, nullptr, 0, {} });
+                }
+            }
+        }
+
+        pool_.wait_idle();
+        take_returned(idle);
+        for (const DaemonConnection& c : idle)
+            ::close(c.fd);
+        reloader_.reset();
+        ::close(listen_fd_);
+        ::close(wake_[0]);
+        ::close(wake_[1]);
+        ::unlink(config_.socket_path.c_str());
+        std::cout << "Daemon stopped after " << jobs_.load() << " jobs ("
+                  << cache_hits_.load() << " cache hits)\n";
+        return 0;
+    }
+
+private:
+    struct CacheKey
+    {
+        std::uint64_t seed, engines, ticks;
+        double        delta_seconds;
+        std::uint64_t config_generation; // Results computed under an older config are not reused.
+
+        bool operator==(const CacheKey& o) const
+        {
+            return seed == o.seed && engines == o.engines && ticks == o.ticks
+                && delta_seconds == o.delta_seconds && config_generation == o.config_generation;
+        }
+    };
+
+    struct CacheKeyHash
+    {
+        std::size_t operator()(const CacheKey& k) const noexcept
+        {
+            std::uint64_t h = fleet_engine_seed(k.seed, k.engines);
+            h = h * 31 + fleet_engine_seed(k.ticks, static_cast<std::uint64_t>(k.delta_seconds * 1000.0));
+            h = h * 31 + k.config_generation;
+            return static_cast<std::size_t>(h);
+        }
+    };
+
+    enum class ClientState
+    {
+        Idle,   // Back in the poll set.
+        Busy,   // Owned by a pool task until its response is written.
+        Closed  // Caller closes the socket.
+    };
+
+    // Reads whatever part of the next request is available without blocking.
+    // Once the request is complete, Ping, Shutdown and rejected requests are
+    // answered here; Fleet and Classify become one pool task each.
+    ClientState receive(DaemonConnection& c)
+    {
+        if (!c.task)
+        {
+            c.task = std::make_shared<DaemonJobTask>();
+            c.task->client = c.fd;
+        }
+        DaemonJobTask& task = *c.task;
+        DaemonResponse response;
+        response.magic = k_daemon_magic;
+        for (;;)
+        {
+            const std::size_t header = sizeof(DaemonRequest);
+            const std::size_t total = header + task.omega.size() * sizeof(double);
+            if (c.received == total && c.received >= header)
+                break;
+            char* into = c.received < header ? reinterpret_cast<char*>(&task.request) + c.received
+                                             : reinterpret_cast<char*>(task.omega.data()) + (c.received - header);
+            std::size_t want = c.received < header ? header - c.received : total - c.received;
+            ssize_t n = ::recv(c.fd, into, want, MSG_DONTWAIT);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                return ClientState::Idle;
+            if (n <= 0)
+                return ClientState::Closed;
+            if (c.received == 0)
+                c.started = std::chrono::steady_clock::now();
+            c.received += static_cast<std::size_t>(n);
+            if (c.received != header)
+                continue;
+
+            // Header complete: validate before accepting any payload.
+            const DaemonRequest& request = task.request;
+            if (request.magic != k_daemon_magic || request.version != k_daemon_version)
+            {
+                response.status = -1;
+                write_exact(c.fd, &response, sizeof(response));
+                return ClientState::Closed;
+            }
+            if (static_cast<DaemonJob>(request.job) == DaemonJob::Classify)
+            {
+                if (request.payload_count > k_daemon_max_payload)
+                {
+                    // The oversized payload cannot be skipped cheaply; reject and drop the connection.
+                    response.status = -3;
+                    write_exact(c.fd, &response, sizeof(response));
+                    return ClientState::Closed;
+                }
+                task.omega.resize(request.payload_count);
+            }
+        }
+
+        std::shared_ptr<DaemonJobTask> complete = std::move(c.task);
+        c.received = 0;
+        jobs_.fetch_add(1, std::memory_order_relaxed);
+        switch (static_cast<DaemonJob>(complete->request.job))
+        {
+        case DaemonJob::Ping:
+            break;
+        case DaemonJob::Shutdown:
+            stopping_.store(true);
+            break;
+        case DaemonJob::Fleet:
+            response.status = fleet_request_status(complete->request);
+            if (response.status != 0)
+                break;
+            submit(std::move(complete));
+            return ClientState::Busy;
+        case DaemonJob::Classify:
+            submit(std::move(complete));
+            return ClientState::Busy;
+        default:
+            response.status = -2;
+            break;
+        }
+        return write_exact(c.fd, &response, sizeof(response)) ? ClientState::Idle : ClientState::Closed;
+    }
+
+    void submit(std::shared_ptr<DaemonJobTask> task)
+    {
+        pool_.submit([this, task](std::size_t worker) {
+            DaemonResponse response;
+            response.magic = k_daemon_magic;
+            bool ok = false;
+            if (static_cast<DaemonJob>(task->request.job) == DaemonJob::Fleet)
+            {
+                run_fleet_job(task->request, response, worker);
+                ok = write_exact(task->client, &response, sizeof(response));
+            }
+            else
+                ok = run_classify_job(task->client, task->omega, response, worker);
+
+            if (!ok)
+            {
+                ::close(task->client);
+                return;
+            }
+            // Hand the connection back to the poll loop for its next request.
+            {
+                std::lock_guard<std::mutex> lock(returned_mutex_);
+                returned_.push_back(task->client);
+            }
+            char byte = 0;
+            (void)!::write(wake_[1], &byte, 1); // A full pipe already guarantees a wakeup.
+        });
+        sim_metrics().queue_depth.set(static_cast<double>(pool_.queued()));
+    }
+
+    void take_returned(std::vector<DaemonConnection>& idle)
+    {
+        std::lock_guard<std::mutex> lock(returned_mutex_);
+        for (int fd : returned_)
+            idle.push_back(DaemonConnection{ fd, nullptr, 0, {} });
+        returned_.clear();
+    }
+
+    // 0, or -4 when a Fleet request is outside the configured limits. Checked
+    // before any allocation, so no request can exhaust the daemon's memory.
+    int fleet_request_status(const DaemonRequest& request) const
+    {
+        bool ok = request.engines <= config_.max_engines && request.ticks <= config_.max_ticks
+               && request.delta_seconds > 0.0 && request.delta_seconds <= 86400.0;
+        return ok ? 0 : -4;
+    }
+
+    void run_fleet_job(const DaemonRequest& request, DaemonResponse& response, std::size_t worker)
+    {
+        // The whole job runs under the config that was current when it started.
+        LiveConfigCell::ReadGuard live_config(live_, readers_[worker]);
+        CacheKey key{ request.seed, request.engines, request.ticks, request.delta_seconds, live_config->generation };
+        {
+            std::lock_guard<std::mutex> lock(cache_mutex_);
+            auto it = cache_.find(key);
+            if (it != cache_.end())
+            {
+                response = it->second;
+                response.cached = 1;
+                cache_hits_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+
+        std::vector<FleetEngineRecord>& arena = arenas_[worker];
+        if (arena.size() < request.engines)
+            arena.resize(request.engines);
+        init_fleet_records(arena.data(), request.engines, request.seed);
+        for (std::size_t i = 0; i < request.engines; ++i)
+            arena[i].source.set_band_mix(live_config->band_mix);
+        BandProfileTable profiles;
+        profiles.add(live_config->profile);
+        simulate_fleet_ticks(arena.data(), request.engines, request.ticks, request.delta_seconds, profiles);
+        FleetSummary summary = summarize_fleet(arena.data(), request.engines, live_config->policy);
+
+        response.engines         = summary.engines;
+        response.successful      = summary.successful;
+        response.maintenance     = summary.maintenance;
+        response.failure         = summary.failure;
+        response.caution_seconds = summary.caution_seconds;
+        response.redline_seconds = summary.redline_seconds;
+
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        if (cache_.size() >= config_.cache_entries)
+            cache_.erase(cache_.begin());
+        cache_.emplace(key, response);
+    }
+
+    bool run_classify_job(int client, const std::vector<double>& omega, DaemonResponse& response,
+                          std::size_t worker)
+    {
+        std::vector<std::uint16_t>& bands = band_scratch_[worker];
+        bands.resize(omega.size());
+        {
+            LiveConfigCell::ReadGuard live_config(live_, readers_[worker]);
+            EnginePowerModel engine;
+            engine.set_verbose(false);
+            for (std::size_t i = 0; i < omega.size(); ++i)
+            {
+                engine.update_from_rpm(omega[i], live_config->profile);
+                bands[i] = static_cast<std::uint16_t>(engine.powerband());
+            }
+        }
+        response.payload_count = bands.size();
+        return write_exact(client, &response, sizeof(response))
+            && write_exact(client, bands.data(), bands.size() * sizeof(std::uint16_t));
+    }
+
+    DaemonConfig                                                    config_;
+    LiveConfigCell                                                  live_;
+    std::unique_ptr<ConfigReloader>                                 reloader_;
+    std::vector<std::vector<FleetEngineRecord>>                     arenas_;
+    std::vector<std::vector<std::uint16_t>>                         band_scratch_;
+    std::vector<int>                                                readers_; // Live config slot per worker.
+    std::unordered_map<CacheKey, DaemonResponse, CacheKeyHash>      cache_;
+    std::mutex                                                      cache_mutex_;
+    std::atomic<bool>                                               stopping_{ false };
+    std::atomic<std::uint64_t>                                      jobs_{ 0 };
+    std::atomic<std::uint64_t>                                      cache_hits_{ 0 };
+    int                                                             listen_fd_{ -1 };
+    int                                                             wake_[2]{ -1, -1 }; // Workers -> poll loop.
+    std::vector<int>                                                returned_;          // Connections done with a job.
+    std::mutex                                                      returned_mutex_;
+    WorkerPool                                                      pool_; // Last: joins before the state above goes away.
+};
+
+// Sends one job to a running daemon and prints the response.
+int run_daemon_client(const std::string& socket_path, const DaemonRequest& request,
+                      const std::vector<double>& omega)
+{
+    int fd = connect_unix_socket(socket_path);
+    if (fd < 0)
+    {
+        std::cerr << "Cannot connect to " << socket_path << ": " << std::strerror(errno) << "\n";
+        return 1;
+    }
+
+    DaemonResponse response;
+    bool ok = write_exact(fd, &request, sizeof(request))
+           && write_exact(fd, omega.data(), omega.size() * sizeof(double))
+           && read_exact(fd, &response, sizeof(response));
+    std::vector<std::uint16_t> bands(ok ? response.payload_count : 0);
+    ok = ok && read_exact(fd, bands.data(), bands.size() * sizeof(std::uint16_t));
+    ::close(fd);
+
+    if (!ok || response.status != 0)
+    {
+        std::cerr << "Daemon job failed (status " << response.status << ")\n";
+        return 1;
+    }
+
+    if (static_cast<DaemonJob>(request.job) == DaemonJob::Fleet)
+    {
+        FleetSummary summary;
+        summary.engines         = response.engines;
+        summary.successful      = response.successful;
+        summary.maintenance     = response.maintenance;
+        summary.failure         = response.failure;
+        summary.caution_seconds = response.caution_seconds;
+        summary.redline_seconds = response.redline_seconds;
+        print_fleet_summary(std::cout, summary);
+        if (response.cached)
+            std::cout << "  (served from daemon cache)\n";
+    }
+    for (std::size_t i = 0; i < bands.size(); ++i)
+        std::cout << omega[i] << " rad/s -> " << to_string(static_cast<EnginePowerBand>(bands[i])) << "\n";
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Metrics exposition: serves the registry in Prometheus text format over HTTP
+// on a Unix socket and/or a loopback TCP port, and rewrites a dump file
+// (atomically, via rename) every interval. Runs on its own thread so the
+// simulation loops never block on a scraper.
+// -----------------------------------------------------------------------------
+struct MetricsConfig
+{
+    std::string file_path;      // Empty = no periodic dump.
+    std::string socket_path;    // Empty = no Unix socket endpoint.
+    int         port{ 0 };      // 0 = no loopback HTTP endpoint.
+    double      interval_sec{ 5.0 };
+
+    bool enabled() const { return !file_path.empty() || !socket_path.empty() || port > 0; }
+};
+
+class MetricsExporter
+{
+public:
+    explicit MetricsExporter(const MetricsConfig& config)
+        : config_(config)
+    {
+        std::string error;
+        if (!config_.socket_path.empty())
+        {
+            int fd = listen_unix_socket(config_.socket_path, error);
+            if (fd >= 0)
+                listen_fds_.push_back(fd);
+            else
+                std::cerr << "Metrics: " << error << "\n";
+        }
+        if (config_.port > 0)
+        {
+            int fd = listen_loopback_tcp(config_.port, error);
+            if (fd >= 0)
+                listen_fds_.push_back(fd);
+            else
+                std::cerr << "Metrics: " << error << "\n";
+        }
+        sim_metrics(); // Register the standard series before the first scrape.
+        thread_ = std::thread([this] { loop(); });
+    }
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    ~MetricsExporter()
+    {
+        stopping_.store(true);
+        thread_.join();
+        update_rates();
+        dump_file(); // Final state for unattended runs.
+        for (int fd : listen_fds_)
+            ::close(fd);
+        if (!config_.socket_path.empty())
+            ::unlink(config_.socket_path.c_str());
+    }
+
+private:
+    static int listen_loopback_tcp(int port, std::string& error)
+    {
+        int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0)
+        {
+            error = std::string("socket: ") + std::strerror(errno);
+            return -1;
+        }
+        int one = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<std::uint16_t>(port));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(fd, 16) != 0)
+        {
+            error = "cannot listen on 127.0.0.1:" + std::to_string(port) + ": " + std::strerror(errno);
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    void loop()
+    {
+        using clock = std::chrono::steady_clock;
+        const auto interval = std::chrono::duration_cast<clock::duration>(
+            std::chrono::duration<double>(std::max(config_.interval_sec, 0.1)));
+        auto next_dump = clock::now() + interval;
+
+        while (!stopping_.load())
+        {
+            std::vector<pollfd> fds;
+            for (int fd : listen_fds_)
+                fds.push_back(pollfd{ fd, POLLIN, 0 });
+            if (fds.empty())
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            else if (::poll(fds.data(), fds.size(), 100) > 0)
+            {
+                for (const pollfd& p : fds)
+                    if (p.revents & POLLIN)
+                        serve(p.fd);
+            }
+
+            if (clock::now() >= next_dump)
+            {
+                update_rates();
+                dump_file();
+                next_dump += interval;
+            }
+        }
+    }
+
+    // Answers one scrape. Any request gets the full exposition as HTTP/1.0.
+    void serve(int listen_fd)
+    {
+        int client = ::accept(listen_fd, nullptr, nullptr);
+        if (client < 0)
+            return;
+        char request[1024];
+        pollfd p{ client, POLLIN, 0 };
+        if (::poll(&p, 1, 200) > 0)
+            (void)::read(client, request, sizeof(request));
+
+        update_rates();
+        std::string body = metrics_registry().render_prometheus();
+        std::string response = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: "
+                             + std::to_string(body.size()) + "\r\n\r\n" + body;
+        write_exact(client, response.data(), response.size());
+        ::close(client);
+    }
+
+    void update_rates()
+    {
+        std::lock_guard<std::mutex> lock(rate_mutex_);
+        auto now = std::chrono::steady_clock::now();
+        std::uint64_t ticks = sim_metrics().ticks.value();
+        double dt = std::chrono::duration<double>(now - last_rate_time_).count();
+        if (dt >= 0.05)
+        {
+            sim_metrics().samples_rate.set((ticks - last_ticks_) / dt);
+            last_ticks_ = ticks;
+            last_rate_time_ = now;
+        }
+    }
+
+    void dump_file()
+    {
+        if (config_.file_path.empty())
+            return;
+        std::string tmp = config_.file_path + ".tmp";
+        {
+            std::ofstream out{ tmp };
+            out << metrics_registry().render_prometheus();
+        }
+        std::rename(tmp.c_str(), config_.file_path.c_str());
+    }
+
+    MetricsConfig     config_;
+    std::vector<int>  listen_fds_;
+    std::atomic<bool> stopping_{ false };
+    std::mutex        rate_mutex_;
+    std::uint64_t     last_ticks_{ 0 };
+    std::chrono::steady_clock::time_point last_rate_time_{ std::chrono::steady_clock::now() };
+    std::thread       thread_;
+};
+
+// -----------------------------------------------------------------------------
+// Command line helper (--flag value pairs, mode flags without a value)
+// -----------------------------------------------------------------------------
+class CommandLine
+{
+public:
+    CommandLine(int argc, char* argv[])
+        : args_(argv + 1, argv + argc)
+    {
+    }
+
+    bool has(const std::string& flag) const
+    {
+        return std::find(args_.begin(), args_.end(), flag) != args_.end();
+    }
+
+    std::string value(const std::string& flag, const std::string& fallback) const
+    {
+        auto it = std::find(args_.begin(), args_.end(), flag);
+        if (it == args_.end() || std::next(it) == args_.end())
+            return fallback;
+        return *std::next(it);
+    }
+
+    double number(const std::string& flag, double fallback) const
+    {
+        std::string text = value(flag, "");
+        if (text.empty())
+            return fallback;
+        char* end = nullptr;
+        double parsed = std::strtod(text.c_str(), &end);
+        return (end && *end == '\0') ? parsed : fallback;
+    }
+
+    // Every argument after `flag` up to the next option.
+    std::vector<std::string> values(const std::string& flag) const
+    {
+        std::vector<std::string> out;
+        auto it = std::find(args_.begin(), args_.end(), flag);
+        if (it != args_.end())
+            for (++it; it != args_.end() && it->compare(0, 2, "--") != 0; ++it)
+                out.push_back(*it);
+        return out;
+    }
+
+private:
+    std::vector<std::string> args_;
+};
+
+// -----------------------------------------------------------------------------
+// Sampled sensor: a producer thread emits omega at a fixed rate (like an
+// interrupt-driven ADC) into a bounded queue drained by the engine model.
+// -----------------------------------------------------------------------------
+enum class OverflowPolicy : std::uint16_t // What the producer does when the queue is full.
+{
+    Block      = 0, // Producer waits for space (sample timing slips).
+    DropOldest = 1, // Overwrite the oldest queued sample.
+    DropNewest = 2, // Discard the sample being produced.
+    Decimate   = 3  // Keep only every Nth sample until the queue drains.
+};
+
+std::string to_string(OverflowPolicy policy)
+{
+    switch (policy)
+    {
+    case OverflowPolicy::Block:      return "block";
+    case OverflowPolicy::DropOldest: return "drop-oldest";
+    case OverflowPolicy::DropNewest: return "drop-newest";
+    case OverflowPolicy::Decimate:   return "decimate";
+    }
+    return "unknown";
+}
+
+bool parse_overflow_policy(const std::string& text, OverflowPolicy& policy)
+{
+    for (OverflowPolicy candidate : { OverflowPolicy::Block, OverflowPolicy::DropOldest,
+                                      OverflowPolicy::DropNewest, OverflowPolicy::Decimate })
+    {
+        if (text == to_string(candidate))
+        {
+            policy = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+struct SensorSample
+{
+    std::uint64_t sequence{ 0 }; // Index of the sample at the ADC.
+    double        omega{ 0.0 };  // rad/s
+};
+
+// Counters are written by the producer and read by anyone (relaxed is enough for reporting).
+struct SensorCounters
+{
+    std::atomic<std::uint64_t> produced{ 0 };
+    std::atomic<std::uint64_t> enqueued{ 0 };
+    std::atomic<std::uint64_t> consumed{ 0 };
+    std::atomic<std::uint64_t> blocked{ 0 };        // Producer waits caused by a full queue.
+    std::atomic<std::uint64_t> dropped_oldest{ 0 };
+    std::atomic<std::uint64_t> dropped_newest{ 0 };
+    std::atomic<std::uint64_t> decimated{ 0 };
+    std::atomic<std::uint64_t> max_depth{ 0 };
+};
+
+class SensorQueue
+{
+public:
+    SensorQueue(std::size_t capacity, OverflowPolicy policy, SensorCounters& counters)
+        : buffer_(capacity > 0 ? capacity : 1),
+          policy_{ policy },
+          counters_(counters)
+    {
+    }
+
+    // Producer side. Applies the overflow policy when the ring is full.
+    void push(const SensorSample& sample)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        counters_.produced.fetch_add(1, std::memory_order_relaxed);
+
+        if (policy_ == OverflowPolicy::Decimate)
+        {
+            // Leave decimation once the consumer has caught up to half capacity.
+            if (decimation_ > 1 && size_ <= buffer_.size() / 2)
+                decimation_ = 1;
+            if (decimation_ > 1 && (sample.sequence % decimation_) != 0)
+            {
+                counters_.decimated.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+
+        if (size_ == buffer_.size())
+        {
+            switch (policy_)
+            {
+            case OverflowPolicy::Block:
+                counters_.blocked.fetch_add(1, std::memory_order_relaxed);
+                not_full_.wait(lock, [this] { return size_ < buffer_.size() || closed_; });
+                if (closed_)
+                    return;
+                break;
+            case OverflowPolicy::DropOldest:
+                head_ = (head_ + 1) % buffer_.size();
+                --size_;
+                counters_.dropped_oldest.fetch_add(1, std::memory_order_relaxed);
+                break;
+            case OverflowPolicy::DropNewest:
+                counters_.dropped_newest.fetch_add(1, std::memory_order_relaxed);
+                return;
+            case OverflowPolicy::Decimate:
+                decimation_ = std::min<std::uint64_t>(decimation_ * 2, k_max_decimation);
+                counters_.decimated.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+
+        buffer_[(head_ + size_) % buffer_.size()] = sample;
+        ++size_;
+        counters_.enqueued.fetch_add(1, std::memory_order_relaxed);
+        if (size_ > counters_.max_depth.load(std::memory_order_relaxed))
+            counters_.max_depth.store(size_, std::memory_order_relaxed);
+        lock.unlock();
+        not_empty_.notify_one();
+    }
+
+    // Consumer side. Returns false once the queue is closed and drained.
+    bool pop(SensorSample& sample)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return size_ > 0 || closed_; });
+        if (size_ == 0)
+            return false;
+
+        sample = buffer_[head_];
+        head_ = (head_ + 1) % buffer_.size();
+        --size_;
+        counters_.consumed.fetch_add(1, std::memory_order_relaxed);
+        lock.unlock();
+        not_full_.notify_one();
+        return true;
+    }
+
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    std::size_t depth() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return size_;
+    }
+
+private:
+    static constexpr std::uint64_t k_max_decimation = 64;
+
+    std::vector<SensorSample> buffer_;
+    std::size_t               head_{ 0 };
+    std::size_t               size_{ 0 };
+    std::uint64_t             decimation_{ 1 };
+    bool                      closed_{ false };
+    OverflowPolicy            policy_;
+    SensorCounters&           counters_;
+
+    mutable std::mutex      mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+};
+
+struct SensorConfig
+{
+    double         rate_hz{ 1000.0 };     // ADC sample rate.
+    double         duration_sec{ 5.0 };   // Wall-clock run time of the producer.
+    std::size_t    queue_capacity{ 256 };
+    OverflowPolicy policy{ OverflowPolicy::Block };
+    double         work_us{ 0.0 };        // Extra synthetic processing cost per consumed sample.
+    bool           verbose{ false };
+    std::string    config_path;           // Live config file, reloaded while running; empty = defaults.
+    double         reload_ms{ 500.0 };
+};
+
+// Runs producer and consumer threads for config.duration_sec and reports counters.
+int run_sensor_mode(const SensorConfig& config)
+{
+    using clock = std::chrono::steady_clock;
+
+    LiveConfig initial;
+    std::string error;
+    if (!config.config_path.empty() && !load_live_config(config.config_path, initial, error))
+    {
+        std::cerr << "Sensor: " << error << "\n";
+        return 1;
+    }
+    LiveConfigCell live(initial);
+    std::unique_ptr<ConfigReloader> reloader;
+    if (!config.config_path.empty())
+        reloader.reset(new ConfigReloader(live, config.config_path, config.reload_ms));
+
+    SensorCounters   counters;
+    SensorQueue      queue(config.queue_capacity, config.policy, counters);
+    EnginePowerModel engine;
+    FlightHours      flight_hours;
+    RPMSource        rpm_source;
+
+    engine.set_verbose(config.verbose);
+
+    const auto period = std::chrono::duration_cast<clock::duration>(
+        std::chrono::duration<double>(1.0 / config.rate_hz));
+    const std::uint64_t total_samples =
+        static_cast<std::uint64_t>(config.rate_hz * config.duration_sec);
+    const auto start = clock::now();
+
+    std::thread producer([&] {
+        // Sample k is due at start + k * period; late samples are emitted back to back.
+        const int reader = live.register_reader();
+        std::uint64_t generation = std::numeric_limits<std::uint64_t>::max(); // Applies the first config too.
+        for (std::uint64_t k = 0; k < total_samples; ++k)
+        {
+            auto due = start + period * static_cast<clock::rep>(k);
+            if (clock::now() < due)
+                std::this_thread::sleep_until(due);
+            {
+                LiveConfigCell::ReadGuard live_config(live, reader);
+                if (live_config->generation != generation)
+                {
+                    generation = live_config->generation;
+                    rpm_source.set_band_mix(live_config->band_mix);
+                }
+            }
+            queue.push(SensorSample{ k, rpm_source.next_omega() });
+        }
+        live.unregister_reader(reader);
+        queue.close();
+    });
+
+    // The hour meter integrates in whole seconds, so each full second of sensor
+    // time is booked to the band current when it completes. Time is taken from
+    // the sequence numbers, so samples the queue dropped or decimated still
+    // count as engine time (in the band of the next sample seen).
+    std::uint64_t next_sequence = 0;  // Samples covered so far.
+    std::uint64_t booked_seconds = 0;
+    clock::duration busy{ 0 };
+    SimMetrics& metrics = sim_metrics();
+    auto book_through = [&](std::uint64_t samples) {
+        next_sequence = std::max(next_sequence, samples);
+        auto due = static_cast<std::uint64_t>(std::floor(static_cast<double>(next_sequence) / config.rate_hz));
+        if (due <= booked_seconds)
+            return;
+        double whole = static_cast<double>(due - booked_seconds);
+        flight_hours.flight_log_hours(engine, whole);
+        if (engine.sample_valid())
+            metrics.band_seconds[static_cast<int>(engine.powerband())]->add(due - booked_seconds);
+        booked_seconds = due;
+    };
+
+    SensorSample sample;
+    const int reader = live.register_reader();
+    while (queue.pop(sample))
+    {
+        auto work_start = clock::now();
+        EnginePowerBand previous = engine.powerband();
+        {
+            LiveConfigCell::ReadGuard live_config(live, reader);
+            engine.update_from_rpm(sample.omega, live_config->profile);
+        }
+        metrics.record_tick(previous, engine.powerband(), 0.0);
+        book_through(sample.sequence + 1);
+        if ((sample.sequence & 63) == 0)
+            metrics.queue_depth.set(static_cast<double>(queue.depth()));
+        if (config.work_us > 0.0)
+        {
+            auto spin_until = work_start + std::chrono::duration_cast<clock::duration>(
+                std::chrono::duration<double, std::micro>(config.work_us));
+            while (clock::now() < spin_until) {}
+        }
+        busy += clock::now() - work_start;
+    }
+    producer.join();
+    book_through(total_samples); // Samples dropped after the last one consumed still ran the engine.
+
+    double elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    double busy_sec = std::chrono::duration<double>(busy).count();
+    Tachometer_Diagnostic diag;
+    std::uint64_t generation = 0;
+    {
+        LiveConfigCell::ReadGuard live_config(live, reader);
+        diag = live_config->policy.evaluate(flight_hours);
+        generation = live_config->generation;
+    }
+    live.unregister_reader(reader);
+
+    std::cout << "Sensor mode: " << config.rate_hz << " Hz, queue " << config.queue_capacity
+              << ", policy " << to_string(config.policy) << "\n";
+    std::cout << "  produced       " << counters.produced.load() << "\n"
+              << "  enqueued       " << counters.enqueued.load() << "\n"
+              << "  consumed       " << counters.consumed.load() << "\n"
+              << "  blocked        " << counters.blocked.load() << "\n"
+              << "  dropped_oldest " << counters.dropped_oldest.load() << "\n"
+              << "  dropped_newest " << counters.dropped_newest.load() << "\n"
+              << "  decimated      " << counters.decimated.load() << "\n"
+              << "  max_depth      " << counters.max_depth.load() << "\n";
+    std::cout << "  elapsed " << elapsed << " s, consumer busy " << busy_sec
+              << " s, headroom " << (elapsed > 0.0 ? 100.0 * (1.0 - busy_sec / elapsed) : 0.0)
+              << " %\n";
+    if (!config.config_path.empty())
+        std::cout << "  config generation " << generation << " (" << config.config_path << ")\n";
+    std::cout << diag.message() << " (code " << diag.code() << ")\n";
+    std::cout << "Caution time (sec): " << flight_hours.caution_time()
+              << ", Redline/OverLimit time (sec): " << flight_hours.redline_time() << "\n";
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// main (left out of the libtachsim build, see tachsim.h)
+// -----------------------------------------------------------------------------
+#ifndef TACHSIM_LIBRARY
+int main(int argc, char* argv[])
+{
+    CommandLine args(argc, argv);
+
+    // Optional for every mode; the exporter writes a final dump when main returns.
+    MetricsConfig metrics_config;
+    metrics_config.file_path    = args.value("--metrics-file", "");
+    metrics_config.socket_path  = args.value("--metrics-socket", "");
+    metrics_config.port         = static_cast<int>(args.number("--metrics-port", 0));
+    metrics_config.interval_sec = args.number("--metrics-interval", metrics_config.interval_sec);
+    std::unique_ptr<MetricsExporter> metrics_exporter;
+    if (metrics_config.enabled())
+        metrics_exporter.reset(new MetricsExporter(metrics_config));
+
+    // Engine degradation for the fleet-based and lifecycle modes (off unless --degrade).
+    DegradationModel degradation;
+    if (args.has("--degrade"))
+    {
+        degradation.derate_rpm_per_hour = static_cast<float>(args.number("--derate-rate", 25.0));
+        degradation.max_derate_rpm      = static_cast<std::int32_t>(args.number("--max-derate", degradation.max_derate_rpm));
+        degradation.overlimit_weight    = static_cast<float>(args.number("--overlimit-weight", degradation.overlimit_weight));
+    }
+
+    // Archive catalog updated by every mode that writes a flight log.
+    const std::string catalog_path = args.has("--no-catalog") ? "" : args.value("--catalog", "tachsim.catalog");
+    if (args.has("--catalog-query"))
+        return run_catalog_query(catalog_path.empty() ? "tachsim.catalog" : catalog_path,
+                                 args.value("--catalog-query", "all"), args.has("--long"));
+
+    if (args.has("--sensor"))
+    {
+        SensorConfig config;
+        config.rate_hz        = args.number("--rate", config.rate_hz);
+        config.duration_sec   = args.number("--duration", config.duration_sec);
+        const double queue    = args.number("--queue", 256);
+        config.queue_capacity = queue >= 1.0 && queue <= 1e7 ? static_cast<std::size_t>(queue) : 0; // 0 = invalid.
+        config.work_us        = args.number("--work-us", config.work_us);
+        config.verbose        = args.has("--verbose");
+        config.config_path    = args.value("--config", "");
+        config.reload_ms      = args.number("--reload-ms", config.reload_ms);
+        if (!parse_overflow_policy(args.value("--policy", "block"), config.policy) || !(config.rate_hz > 0.0)
+            || !(config.duration_sec > 0.0) || !(config.rate_hz * config.duration_sec < 1e15) // Finite sample count.
+            || config.queue_capacity == 0)
+        {
+            std::cerr << "Usage: --sensor [--rate HZ] [--duration SEC] [--queue N (1..10000000)]"
+                         " [--policy block|drop-oldest|drop-newest|decimate] [--work-us US] [--verbose]"
+                         " [--config FILE] [--reload-ms MS]\n";
+            return 1;
+        }
+        return run_sensor_mode(config);
+    }
+
+    if (args.has("--generate"))
+    {
+        GeneratorConfig config;
+        config.output_path      = args.value("--generate", config.output_path);
+        config.seed             = static_cast<std::uint64_t>(args.number("--seed", 1));
+        config.mean_dwell_ticks = args.number("--dwell", config.mean_dwell_ticks);
+        config.noise            = args.number("--noise", config.noise);
+        config.delta_seconds    = args.number("--delta", config.delta_seconds);
+        config.threads          = static_cast<std::size_t>(args.number("--threads", 0));
+        config.catalog_path     = catalog_path;
+        if (!parse_byte_size(args.value("--size", "1M"), config.target_bytes)
+            || !parse_log_format(args.value("--format", "csv"), config.format)
+            || (args.has("--mix") && !parse_band_mix(args.value("--mix", ""), config.band_mix)))
+        {
+            std::cerr << "Usage: --generate FILE [--size 1M..100G] [--format csv] [--seed S]"
+                         " [--mix w0,w1,w2,w3,w4,w5,w6] [--dwell TICKS] [--noise FRACTION]"
+                         " [--delta SEC] [--threads N]\n";
+            return 1;
+        }
+        SyntheticLogGenerator generator(config);
+        return generator.run();
+    }
+
+    if (args.has("--bench-reduction"))
+    {
+        std::size_t values  = static_cast<std::size_t>(args.number("--values", 1 << 24));
+        std::size_t threads = static_cast<std::size_t>(args.number("--threads", 8));
+        return run_reduction_benchmark(std::max<std::size_t>(values, 1), std::max<std::size_t>(threads, 1));
+    }
+
+    if (args.has("--ensemble"))
+    {
+        EnsembleConfig config;
+        config.runs          = static_cast<std::uint64_t>(args.number("--runs", 1000));
+        config.ticks         = static_cast<std::uint64_t>(args.number("--ticks", 50 * 60));
+        config.seed          = static_cast<std::uint64_t>(args.number("--seed", 1));
+        config.delta_seconds = args.number("--delta", config.delta_seconds);
+        config.threads       = static_cast<std::size_t>(args.number("--threads", 0));
+        config.csv_path      = args.value("--out", config.csv_path);
+        config.svg_path      = args.value("--fan", "");
+        if (config.runs == 0 || config.ticks == 0 || !(config.delta_seconds > 0.0))
+        {
+            std::cerr << "Usage: --ensemble [--runs R] [--ticks T] [--seed S] [--delta SEC] [--threads N]"
+                         " [--out FILE.csv] [--fan FILE.svg]\n";
+            return 1;
+        }
+        return run_ensemble_mode(config);
+    }
+
+    if (args.has("--compare-policies"))
+    {
+        CrnConfig config;
+        config.runs          = static_cast<std::uint64_t>(args.number("--runs", 2000));
+        config.ticks         = static_cast<std::uint64_t>(args.number("--ticks", 50 * 60));
+        config.seed          = static_cast<std::uint64_t>(args.number("--seed", 1));
+        config.delta_seconds = args.number("--delta", config.delta_seconds);
+        config.antithetic    = args.has("--antithetic");
+        config.independent   = args.has("--independent");
+        config.threads       = static_cast<std::size_t>(args.number("--threads", 0));
+        std::vector<std::string> specs = args.values("--variants");
+        if (specs.empty())
+            specs = { "standard", "derated:caution_min=8800,redline_min=9600" };
+        std::string error;
+        for (const std::string& spec : specs)
+        {
+            PolicyVariant variant;
+            if (!parse_policy_variant(spec, variant, error))
+                break;
+            config.variants.push_back(variant);
+        }
+        if (!error.empty() || config.variants.size() < 2 || config.runs < 2 || config.ticks == 0)
+        {
+            if (!error.empty())
+                std::cerr << "Compare policies: " << error << "\n";
+            std::cerr << "Usage: --compare-policies [--runs N] [--ticks T] [--seed S] [--delta SEC] [--antithetic]"
+                         " [--independent] [--threads N] [--variants NAME[:key=value,...] NAME[:...] ...]\n";
+            return 1;
+        }
+        return run_policy_comparison(config);
+    }
+
+    if (args.has("--verify"))
+    {
+        std::vector<std::string> paths = args.values("--verify");
+        if (paths.empty())
+        {
+            std::cerr << "Usage: --verify FILE... [--threads N]\n";
+            return 1;
+        }
+        std::size_t threads = static_cast<std::size_t>(args.number("--threads", std::thread::hardware_concurrency()));
+        return run_verify_mode(paths, std::max<std::size_t>(threads, 1));
+    }
+
+    if (args.has("--tui"))
+    {
+        TuiConfig config;
+        config.duration_sec  = args.number("--duration", config.duration_sec);
+        config.fps           = args.number("--fps", config.fps);
+        config.delta_seconds = args.number("--delta", config.delta_seconds);
+        if (!(config.fps > 0.0))
+        {
+            std::cerr << "Usage: --tui [--duration SEC] [--fps N] [--delta SEC]\n";
+            return 1;
+        }
+        return run_tui_mode(config);
+    }
+
+    if (args.has("--replay"))
+    {
+        ReplayConfig config;
+        config.input_path                  = args.value("--replay", config.input_path);
+        config.output_path                 = args.value("--out", config.output_path);
+        config.catalog_path                = catalog_path;
+        config.limits.max_rpm              = args.number("--max-rpm", config.limits.max_rpm);
+        config.limits.max_slew_rpm_per_sec = args.number("--max-slew", config.limits.max_slew_rpm_per_sec);
+        return run_replay_mode(config);
+    }
+
+    if (args.has("--fleet"))
+    {
+        FleetConfig config;
+        config.engines       = static_cast<std::uint64_t>(args.number("--engines", 100));
+        config.ticks         = static_cast<std::uint64_t>(args.number("--ticks", 50 * 60));
+        config.batch         = static_cast<std::uint64_t>(args.number("--batch", 60));
+        config.seed          = static_cast<std::uint64_t>(args.number("--seed", 1));
+        config.delta_seconds = args.number("--delta", config.delta_seconds);
+        config.state_path    = args.value("--state", "");
+        config.degradation   = degradation;
+        config.heatmap_path  = args.value("--heatmap", "");
+        config.heatmap_bucket_hours = args.number("--heatmap-bucket", config.heatmap_bucket_hours);
+        config.heatmap_rpm_bin      = args.number("--heatmap-rpm-bin", config.heatmap_rpm_bin);
+        config.registry_path        = args.value("--registry", "");
+        config.cohort_csv_path      = args.value("--cohort-out", "");
+        config.threads              = static_cast<std::size_t>(args.number("--threads", 0));
+        if (args.has("--group-by") && !parse_cohort_fields(args.value("--group-by", ""), config.cohort_fields))
+        {
+            std::cerr << "Usage: --group-by type,operator,route,year (any subset)\n";
+            return 1;
+        }
+        if (!config.cohort_fields && (!config.registry_path.empty() || !config.cohort_csv_path.empty()))
+            config.cohort_fields = CohortAll;
+        std::string error;
+        if (args.has("--profiles") && !load_profile_mix(args.value("--profiles", ""), config.profiles, error))
+        {
+            std::cerr << "Profiles: " << error << "\n";
+            return 1;
+        }
+        return run_fleet_mode(config);
+    }
+
+    if (args.has("--maintenance-plan"))
+    {
+        MaintenanceConfig config;
+        config.fleet.engines       = static_cast<std::uint64_t>(args.number("--engines", 10000));
+        config.fleet.seed          = static_cast<std::uint64_t>(args.number("--seed", 1));
+        config.fleet.delta_seconds = args.number("--delta", config.fleet.delta_seconds);
+        config.days                = static_cast<std::size_t>(args.number("--days", 30));
+        config.slots_per_day       = static_cast<std::size_t>(args.number("--slots", 50));
+        config.ticks_per_day       = static_cast<std::size_t>(args.number("--ticks-per-day", 600));
+        config.horizon_days        = args.number("--horizon", config.horizon_days);
+        config.fleet.degradation   = degradation;
+        std::string error;
+        if (args.has("--profiles") && !load_profile_mix(args.value("--profiles", ""), config.fleet.profiles, error))
+        {
+            std::cerr << "Profiles: " << error << "\n";
+            return 1;
+        }
+        return run_maintenance_mode(config);
+    }
+
+    if (args.has("--lifecycle"))
+    {
+        LifecycleConfig config;
+        config.engines           = static_cast<std::uint64_t>(args.number("--engines", 100));
+        config.seed              = static_cast<std::uint64_t>(args.number("--seed", 1));
+        config.life_hours        = args.number("--life-hours", config.life_hours);
+        config.mean_flight_hours = args.number("--flight-hours", config.mean_flight_hours);
+        config.mean_ground_hours = args.number("--ground-hours", config.mean_ground_hours);
+        config.delta_seconds     = args.number("--delta", config.delta_seconds);
+        config.detail_every      = static_cast<std::uint64_t>(args.number("--detail-every", 0));
+        config.detail_path       = args.value("--detail-log", "");
+        config.threads           = static_cast<std::size_t>(args.number("--threads", 0));
+        config.degradation       = degradation;
+        config.sample_failures   = args.has("--hazard");
+        config.survival_path     = args.value("--survival", "");
+        config.survival_bin_hours = args.number("--survival-bin", config.survival_bin_hours);
+        config.hazard.shape       = args.number("--weibull-shape", config.hazard.shape);
+        config.hazard.scale_hours = args.number("--weibull-scale", config.hazard.scale_hours);
+        if (args.has("--hazard-multipliers") && !parse_band_mix(args.value("--hazard-multipliers", ""), config.hazard.multiplier))
+        {
+            std::cerr << "Usage: --hazard-multipliers m0,m1,m2,m3,m4,m5,m6 (PowerOff..OverLimit, non-negative)\n";
+            return 1;
+        }
+        return run_lifecycle_mode(config);
+    }
+
+    if (args.has("--shard-fleet"))
+    {
+        ShardConfig config;
+        config.fleet.engines       = static_cast<std::uint64_t>(args.number("--engines", 1000));
+        config.fleet.ticks         = static_cast<std::uint64_t>(args.number("--ticks", 50 * 60));
+        config.fleet.seed          = static_cast<std::uint64_t>(args.number("--seed", 1));
+        config.fleet.delta_seconds = args.number("--delta", config.fleet.delta_seconds);
+        config.processes           = static_cast<std::size_t>(args.number("--procs", 4));
+        config.retries             = static_cast<std::size_t>(args.number("--retries", 1));
+        config.worker_mem_mb       = static_cast<std::size_t>(args.number("--worker-mem-mb", 0));
+        if (const char* crash = std::getenv("TACHSIM_INJECT_CRASH"))
+            config.inject_crash = std::strtol(crash, nullptr, 10);
+        config.fleet.degradation   = degradation;
+        config.fleet.heatmap_path  = args.value("--heatmap", "");
+        config.fleet.heatmap_bucket_hours = args.number("--heatmap-bucket", config.fleet.heatmap_bucket_hours);
+        config.fleet.heatmap_rpm_bin      = args.number("--heatmap-rpm-bin", config.fleet.heatmap_rpm_bin);
+        std::string error;
+        if (args.has("--profiles") && !load_profile_mix(args.value("--profiles", ""), config.fleet.profiles, error))
+        {
+            std::cerr << "Profiles: " << error << "\n";
+            return 1;
+        }
+        return run_sharded_fleet(config);
+    }
+
+    if (args.has("--daemon"))
+    {
+        DaemonConfig config;
+        config.socket_path   = args.value("--socket", config.socket_path);
+        config.workers       = static_cast<std::size_t>(args.number("--workers", 4));
+        config.arena_engines = static_cast<std::size_t>(args.number("--arena-engines", 1024));
+        config.cache_entries = static_cast<std::size_t>(args.number("--cache", 4096));
+        config.max_engines   = static_cast<std::uint64_t>(std::max(0.0, args.number("--max-engines", 100000)));
+        config.max_ticks     = static_cast<std::uint64_t>(std::max(0.0, args.number("--max-ticks", 1000000)));
+        config.config_path   = args.value("--config", "");
+        config.reload_ms     = args.number("--reload-ms", config.reload_ms);
+        LiveConfig initial;
+        std::string error;
+        if (!config.config_path.empty() && !load_live_config(config.config_path, initial, error))
+        {
+            std::cerr << "Daemon: " << error << "\n";
+            return 1;
+        }
+        SimulationDaemon daemon(config, initial);
+        return daemon.run();
+    }
+
+    if (args.has("--daemon-job"))
+    {
+        DaemonRequest request;
+        request.magic         = k_daemon_magic;
+        request.version       = k_daemon_version;
+        request.seed          = static_cast<std::uint64_t>(args.number("--seed", 1));
+        request.engines       = static_cast<std::uint64_t>(args.number("--engines", 100));
+        request.ticks         = static_cast<std::uint64_t>(args.number("--ticks", 50 * 60));
+        request.delta_seconds = args.number("--delta", 60.0);
+
+        std::string job = args.value("--daemon-job", "fleet");
+        std::vector<double> omega;
+        if (job == "fleet")
+            request.job = static_cast<std::uint16_t>(DaemonJob::Fleet);
+        else if (job == "ping")
+            request.job = static_cast<std::uint16_t>(DaemonJob::Ping);
+        else if (job == "shutdown")
+            request.job = static_cast<std::uint16_t>(DaemonJob::Shutdown);
+        else if (job == "classify")
+        {
+            request.job = static_cast<std::uint16_t>(DaemonJob::Classify);
+            for (int i = 1; i < argc; ++i)
+                if (std::string(argv[i]) == "--omega" && i + 1 < argc)
+                    omega.push_back(std::strtod(argv[++i], nullptr));
+            request.payload_count = omega.size();
+        }
+        else
+        {
+            std::cerr << "Usage: --daemon-job fleet|classify|ping|shutdown [--socket PATH]"
+                         " [--engines N] [--ticks T] [--seed S] [--omega W ...]\n";
+            return 1;
+        }
+        return run_daemon_client(args.value("--socket", "tachsim.sock"), request, omega);
+    }
+
+    // Runs are reproducible with --seed; otherwise a fresh seed is drawn and cataloged.
+    const std::uint32_t seed = args.has("--seed") ? static_cast<std::uint32_t>(args.number("--seed", 0))
+                                                  : std::random_device{}();
+    const std::string log_path = args.value("--log", "flight_log.csv");
+
+    // 50-hour endurance simulation, 1-minute resolution by default (easier to test diagnostics)
+    // The hour meter books whole seconds per tick, so a fractional delta would
+    // be booked rounded while the log and catalog carry the exact value.
+    const double delta_seconds = args.number("--delta", 60.0);
+    if (!(delta_seconds >= 1.0 && delta_seconds <= 50 * 3600.0) || delta_seconds != std::floor(delta_seconds))
+    {
+        std::cerr << "Usage: --delta SEC (whole seconds, 1 to 180000)\n";
+        return 1;
+    }
+    const int total_ticks = static_cast<int>(std::lround(50 * 3600.0 / delta_seconds));
+
+    // --source ou: mean-reverting RPM through mission phases instead of independent band draws.
+    const std::string source_kind = args.value("--source", "bands");
+    MeanRevertingRPMSource::Params ou_params;
+    ou_params.tau_seconds   = args.number("--ou-tau", ou_params.tau_seconds);
+    ou_params.stationary_sd = args.number("--ou-sd", ou_params.stationary_sd);
+    std::vector<MissionPhase> phases = MeanRevertingRPMSource::default_phases();
+    if ((source_kind != "bands" && source_kind != "ou")
+        || (args.has("--phases") && !MeanRevertingRPMSource::parse_phases(args.value("--phases", ""), phases)))
+    {
+        std::cerr << "Usage: [--source bands|ou] [--ou-tau SEC] [--ou-sd RPM] [--phases name:minutes:rpm,...]\n";
+        return 1;
+    }
+    const bool mean_reverting = source_kind == "ou";
+
+    EnginePowerModel engine;
+    FlightHours      flight_hours;
+    RPMSource        rpm_source{ seed };
+    MeanRevertingRPMSource ou_source{ seed, ou_params, phases };
+    CatalogRecorder  catalog;
+
+    ChecksummedLogFile log_file{ log_path };
+    if (!log_file)
+    {
+        std::cerr << "Failed to open " << log_path << "\n";
+        return 1;
+    }
+
+    // Write header once
+    flight_hours.csv_header(log_file);
+
+    for (int tick = 0; tick < total_ticks; ++tick)
+    {
+        EnginePowerBand previous = engine.powerband();
+        if (mean_reverting)
+            ou_source.drive_engine(engine, delta_seconds);              // 1) RPM wanders toward the phase setpoint
+        else
+            rpm_source.drive_engine(engine);                           // 1) random RPM across bands
+        flight_hours.flight_log_hours(engine, delta_seconds);          // 2) accumulate time by band
+        flight_hours.csv_row(log_file, engine, tick * delta_seconds);  // 3) CSV output
+        sim_metrics().record_tick(previous, engine.powerband(), delta_seconds);
+        catalog.observe(engine.powerband(), engine.raw_rpm(), delta_seconds * engine.sample_valid());
+    }
+    std::string log_error;
+    if (!log_file.close(log_error))
+    {
+        std::cerr << log_error << "\n";
+        return 1;
+    }
+    std::string run_config = "ticks=" + std::to_string(total_ticks);
+    if (mean_reverting)
+        run_config += " source=ou tau=" + std::to_string(ou_params.tau_seconds)
+                    + " sd=" + std::to_string(ou_params.stationary_sd);
+    catalog_log(catalog_path, catalog.entry(log_path, "main", run_config, seed,
+                                            delta_seconds, log_file.bytes_written()));
+
+     // -------------------------------------------------------------------------
+    // Diagnostics based on time spent in bad bands (NORMAL POLICY)
+    // -------------------------------------------------------------------------
+    std::int64_t caution_sec = flight_hours.caution_time();
+    std::int64_t redline_sec = flight_hours.redline_time();
+
+    Tachometer_Diagnostic diag = DiagnosticPolicy{}.evaluate(flight_hours);
 
     std::cout << diag.message() << " (code " << diag.code() << ")\n";
     std::cout << "Caution time (sec): " << caution_sec
               << ", Redline/OverLimit time (sec): " << redline_sec << "\n";
 
-    std::cout << "Simulation Finished. Check flight_log.csv\n";
+    std::cout << "Simulation Finished. Check " << log_path << "\n";
     return 0;
 }
+#endif // TACHSIM_LIBRARY
@@ -0,0 +1,122 @@
+/*
+ * tachsim.h - C ABI for the Jet Engine Tachometer Simulator (libtachsim)
+ *
+ * Build the shared library from the simulator source:
+ *   g++ -std=c++17 -O2 -fPIC -shared -fvisibility=hidden -DTACHSIM_LIBRARY \
+ *       Tachometer_Simulator1.2.cpp -o libtachsim.so
+ *
+ * Rules of the ABI:
+ *   - Nothing here prints or allocates on the caller's behalf; every buffer
+ *     is owned by the caller.
+ *   - Functions return TACHSIM_OK (0) or a negative tachsim_status.
+ *   - Structs only grow at the end; check tachsim_abi_version() at load time.
+ */
+#ifndef TACHSIM_H
+#define TACHSIM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(TACHSIM_BUILDING) /* Set by the library source, never by consumers. */
+#    define TACHSIM_API __declspec(dllexport)
+#  else
+#    define TACHSIM_API __declspec(dllimport)
+#  endif
+#else
+#  define TACHSIM_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TACHSIM_ABI_VERSION 2u /* 2: tachsim_create returns a status. */
+
+typedef enum tachsim_status
+{
+    TACHSIM_OK            =  0,
+    TACHSIM_ERR_NULL      = -1, /* Required pointer argument was NULL. */
+    TACHSIM_ERR_ARGUMENT  = -2, /* Argument out of range. */
+    TACHSIM_ERR_ALLOC     = -3  /* Handle allocation failed. */
+} tachsim_status;
+
+/* Values match enum class EnginePowerBand. */
+typedef enum tachsim_band
+{
+    TACHSIM_BAND_POWER_OFF  = 0,
+    TACHSIM_BAND_IDLE       = 1,
+    TACHSIM_BAND_CLIMB      = 2,
+    TACHSIM_BAND_CRUISE     = 3,
+    TACHSIM_BAND_CAUTION    = 4,
+    TACHSIM_BAND_RED_LINE   = 5,
+    TACHSIM_BAND_OVER_LIMIT = 6
+} tachsim_band;
+
+typedef struct tachsim_flight_hours
+{
+    int64_t total_seconds;   /* Engine running time. */
+    int64_t caution_seconds;
+    int64_t redline_seconds; /* RedLine + OverLimit. */
+    int32_t hours;
+    int32_t minutes;
+    int32_t seconds;
+    int32_t reserved;
+} tachsim_flight_hours;
+
+typedef struct tachsim_diagnostics
+{
+    int32_t  status;       /* 0 successful, 1 maintenance required, 2 system failure. */
+    int32_t  code;
+    int32_t  filtered_rpm; /* Last sample. */
+    uint16_t band;         /* Last sample, tachsim_band. */
+    uint16_t reserved;
+    double   raw_rpm;      /* Last sample. */
+    uint64_t ticks;        /* Samples applied since create/reset. */
+} tachsim_diagnostics;
+
+typedef struct tachsim_simulator tachsim_simulator;
+
+TACHSIM_API uint32_t tachsim_abi_version(void);
+
+/* One engine, hour meter and seeded RPM source. Stores the handle in *out;
+ * returns TACHSIM_ERR_ALLOC (and stores NULL) if it cannot be allocated. */
+TACHSIM_API int  tachsim_create(uint64_t seed, tachsim_simulator** out);
+TACHSIM_API void tachsim_destroy(tachsim_simulator* sim);
+TACHSIM_API int  tachsim_reset(tachsim_simulator* sim, uint64_t seed);
+
+/* Stateless: classify `count` angular speeds (rad/s). Either output may be NULL. */
+TACHSIM_API int tachsim_classify_omega(const double* omega, size_t count,
+                                       int32_t* rpm_out, uint16_t* band_out);
+
+/* Sample validity flags written by tachsim_sanitize_omega (0 = valid). */
+#define TACHSIM_SAMPLE_NON_FINITE 0x01u
+#define TACHSIM_SAMPLE_NEGATIVE   0x02u
+#define TACHSIM_SAMPLE_OVER_RANGE 0x04u
+#define TACHSIM_SAMPLE_SLEW       0x08u
+
+/* Stateless: clamp `count` angular speeds taken `sample_seconds` apart into
+ * omega_out (may alias omega) and write one flag byte per sample. Non-finite
+ * and negative samples become 0, samples above max_rpm are clamped to it. */
+TACHSIM_API int tachsim_sanitize_omega(const double* omega, size_t count, double sample_seconds,
+                                       double max_rpm, double max_slew_rpm_per_sec,
+                                       double* omega_out, uint8_t* flags_out);
+
+/* Run `ticks` ticks from the built-in RPM source, accumulating flight hours.
+ * Per-tick RPM and band are written when the outputs are non-NULL. */
+TACHSIM_API int tachsim_run_ticks(tachsim_simulator* sim, size_t ticks, double delta_seconds,
+                                  int32_t* rpm_out, uint16_t* band_out);
+
+/* Same as tachsim_run_ticks, but driven by caller-supplied angular speeds.
+ * Non-finite, negative or out-of-range samples are clamped and book no time. */
+TACHSIM_API int tachsim_feed_omega(tachsim_simulator* sim, const double* omega, size_t count,
+                                   double delta_seconds, int32_t* rpm_out, uint16_t* band_out);
+
+TACHSIM_API int tachsim_get_flight_hours(const tachsim_simulator* sim, tachsim_flight_hours* out);
+TACHSIM_API int tachsim_get_diagnostics(const tachsim_simulator* sim, tachsim_diagnostics* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TACHSIM_H */